@@ -0,0 +1,154 @@
+#ifndef BOARD_PROFILE_H
+#define BOARD_PROFILE_H
+
+#include <Arduino.h>
+#include <type_traits>
+#include <utility>
+
+// Só os perfis com o DHT incluem a biblioteca do sensor
+#if !defined(BOARD_PROFILE_LITE)
+#define BOARD_HAS_DHT 1
+#include "DhtSensor.h" // DhtSensor<Pin, Type>
+#endif
+
+// =========================================================
+// Perfis de placa resolvidos em tempo de compilação.
+//
+// Pinos, sensores, canais de PWM e funcionalidades ficam no tipo do
+// perfil. O código testa o perfil com 'if constexpr', então drivers e
+// rotas que o perfil não usa nem chegam ao binário.
+//
+// O perfil é escolhido no platformio.ini (-DBOARD_PROFILE_...).
+// =========================================================
+
+// --- Funcionalidades opcionais ---
+enum BoardFeature : uint32_t
+{
+    FEATURE_TELEMETRY = 1 << 0, // MQTT (TelemetryPublisher)
+    FEATURE_OTA = 1 << 1,       // POST /update
+    FEATURE_HISTORY = 1 << 2,   // Histórico de 32 dias e GET /history.json
+    FEATURE_TRACE = 1 << 3,     // EventTracer e GET /trace.json
+    FEATURE_BEACON = 1 << 4,    // Status por UDP multicast (TelemetryBeacon)
+    FEATURE_TLS = 1 << 5,       // Dashboard por HTTPS na porta 443 (SecureDashboard)
+};
+
+static constexpr uint32_t FEATURE_ALL = FEATURE_TELEMETRY | FEATURE_OTA | FEATURE_HISTORY | FEATURE_TRACE |
+                                        FEATURE_BEACON | FEATURE_TLS;
+
+// --- Sensores ---
+
+/**
+ * Sensor de luminosidade (LDR) num pino do ADC.
+ */
+template <uint8_t Pin>
+struct LdrSensor
+{
+    static constexpr bool present = true;
+    static constexpr uint8_t pin = Pin;
+};
+
+/**
+ * Placa sem o sensor. O driver vazio só existe para o código compilar.
+ */
+struct NoSensor
+{
+    static constexpr bool present = false;
+    static constexpr uint8_t pin = 0;
+
+    struct Driver
+    {
+        void begin() {}
+        float readTemperature() { return NAN; }
+        float readHumidity() { return NAN; }
+    };
+    static Driver make() { return Driver(); }
+};
+
+// --- Saídas PWM (LEDC) ---
+
+/**
+ * Canais de PWM: um canal LEDC por pino, todos com a mesma frequência
+ * e resolução. O canal i usa o i-ésimo pino.
+ */
+template <uint32_t Frequency, uint8_t Resolution, uint8_t... Pins>
+struct PwmOutput
+{
+    static_assert(sizeof...(Pins) > 0, "O perfil precisa de ao menos um canal de PWM");
+    static_assert(sizeof...(Pins) <= 16, "O ESP32 tem 16 canais LEDC");
+
+    static constexpr uint32_t frequency = Frequency;
+    static constexpr uint8_t resolution = Resolution;
+    static constexpr uint8_t channels = sizeof...(Pins);
+    static constexpr uint8_t pins[] = {Pins...};
+    static constexpr int maxDuty = (1 << Resolution) - 1;
+};
+
+// --- Perfil ---
+
+template <class DhtT, class LdrT, class PwmT, uint32_t Features>
+struct BoardProfile
+{
+    using Dht = DhtT;
+    using Ldr = LdrT;
+    using Pwm = PwmT;
+
+    static constexpr bool has(uint32_t feature) { return (Features & feature) == feature; }
+};
+
+#ifdef BOARD_HAS_DHT
+// Placa de desenvolvimento original: DHT11 + LDR, um canal, tudo ligado
+using ProfileDevKit = BoardProfile<DhtSensor<25, DHT11>, LdrSensor<35>, PwmOutput<5000, 8, 27>, FEATURE_ALL>;
+
+// Dois canais de luz com os mesmos sensores, sem telemetria MQTT
+using ProfileDualChannel = BoardProfile<DhtSensor<25, DHT11>, LdrSensor<35>, PwmOutput<5000, 8, 27, 26>,
+                                        FEATURE_OTA | FEATURE_HISTORY | FEATURE_TRACE | FEATURE_BEACON | FEATURE_TLS>;
+#endif
+
+// SKU enxuto: só o controle da luz pelo horário, dashboard e OTA
+using ProfileLite = BoardProfile<NoSensor, NoSensor, PwmOutput<5000, 8, 27>, FEATURE_OTA>;
+
+#if defined(BOARD_PROFILE_LITE)
+using ActiveBoard = ProfileLite;
+#elif defined(BOARD_PROFILE_DUAL_CHANNEL)
+using ActiveBoard = ProfileDualChannel;
+#else
+using ActiveBoard = ProfileDevKit;
+#endif
+
+// --- Objetos opcionais ---
+
+/**
+ * Guarda o objeto de uma funcionalidade que o perfil tem.
+ */
+template <class T>
+struct FeatureOn
+{
+    T value;
+
+    template <class... Args>
+    explicit FeatureOn(Args &&...args) : value(std::forward<Args>(args)...) {}
+    T *operator->() { return &value; }
+};
+
+/**
+ * Lugar vazio de uma funcionalidade que o perfil não tem: não constrói o
+ * objeto nem ocupa RAM. O operator-> só existe para o código dentro de
+ * 'if constexpr (ActiveBoard::has(...))' compilar; nunca é executado.
+ */
+template <class T>
+struct FeatureOff
+{
+    template <class... Args>
+    explicit constexpr FeatureOff(Args &&...) {}
+    T *operator->() const { return nullptr; }
+};
+
+/**
+ * Objeto global que só existe se o perfil tiver a funcionalidade:
+ *   ProfileSlot<SensorHistory, ActiveBoard::has(FEATURE_HISTORY)> history;
+ * Usado com '->' (history->begin()).
+ */
+template <class T, bool Enabled>
+using ProfileSlot = std::conditional_t<Enabled, FeatureOn<T>, FeatureOff<T>>;
+
+#endif // BOARD_PROFILE_H
@@ -0,0 +1,21 @@
+#ifndef DHT_SENSOR_H
+#define DHT_SENSOR_H
+
+// Só é incluído pelo BoardProfile.h nos perfis que têm o DHT: o perfil sem
+// o sensor não depende da biblioteca (nem do platformio.ini a instalar)
+#include <Adafruit_Sensor.h>
+#include <DHT.h>
+
+/**
+ * Sensor de temperatura/humidade DHT.
+ */
+template <uint8_t Pin, uint8_t Type>
+struct DhtSensor
+{
+    static constexpr bool present = true;
+    static constexpr uint8_t pin = Pin;
+    using Driver = DHT;
+    static Driver make() { return DHT(Pin, Type); }
+};
+
+#endif // DHT_SENSOR_H
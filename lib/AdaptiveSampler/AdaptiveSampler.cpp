@@ -0,0 +1,75 @@
+#include "AdaptiveSampler.h"
+#include <math.h>
+
+ChangeDetector::ChangeDetector(float rate_threshold, float noise_threshold, unsigned long window_ms, float alpha)
+    : _rateThreshold(rate_threshold), _noiseThreshold(noise_threshold), _window(window_ms), _alpha(alpha)
+{
+    _filtered = 0;
+    _variance = 0;
+    _windowStart = 0;
+    _windowElapsed = 0;
+    _moving = false;
+    _noisy = false;
+    _primed = false;
+}
+
+bool ChangeDetector::update(float value, unsigned long dt_ms)
+{
+    // Primeira leitura: não há com o que comparar. Fica "em mudança" até
+    // fechar a primeira janela.
+    if (!_primed)
+    {
+        _filtered = value;
+        _variance = 0;
+        _windowStart = value;
+        _windowElapsed = 0;
+        _moving = true;
+        _noisy = false;
+        _primed = true;
+        return true;
+    }
+
+    float residual = value - _filtered;
+    _filtered += _alpha * residual;
+    _variance = (1 - _alpha) * (_variance + _alpha * residual * residual);
+
+    // Desvio: reage na hora (um degrau grande aparece já na primeira leitura)
+    float noiseLimit = _noisy ? _noiseThreshold * CHANGE_HYSTERESIS : _noiseThreshold;
+    _noisy = _variance > noiseLimit * noiseLimit;
+
+    // Derivada: só é reavaliada quando a janela fecha, sempre sobre o
+    // mesmo tempo, seja qual for o intervalo entre leituras
+    _windowElapsed += dt_ms;
+    if (_windowElapsed >= _window)
+    {
+        float rate = fabsf(_filtered - _windowStart) * 1000.0f / _windowElapsed;
+        float rateLimit = _moving ? _rateThreshold * CHANGE_HYSTERESIS : _rateThreshold;
+        _moving = rate > rateLimit;
+        _windowStart = _filtered;
+        _windowElapsed = 0;
+    }
+
+    return _moving || _noisy;
+}
+
+AdaptiveSampler::AdaptiveSampler(unsigned long min_interval, unsigned long max_interval)
+    : _minInterval(min_interval), _maxInterval(max_interval)
+{
+    _interval = min_interval;
+    _lastRead = 0;
+}
+
+void AdaptiveSampler::schedule(bool active, unsigned long now)
+{
+    _lastRead = now;
+
+    if (active)
+    {
+        _interval = _minInterval;
+    }
+    else
+    {
+        // Estável: recua exponencialmente
+        _interval = _interval * 2 > _maxInterval ? _maxInterval : _interval * 2;
+    }
+}
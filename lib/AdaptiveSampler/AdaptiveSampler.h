@@ -0,0 +1,101 @@
+#ifndef ADAPTIVE_SAMPLER_H
+#define ADAPTIVE_SAMPLER_H
+
+#include <stdint.h> // Só tipos: roda também no env native
+
+// Fração do limite abaixo da qual um sinal "em mudança" volta a "estável"
+#ifndef CHANGE_HYSTERESIS
+#define CHANGE_HYSTERESIS 0.7f
+#endif
+
+/**
+ * Detecta mudança num sinal ruidoso.
+ *
+ * Mantém uma média exponencial (sinal filtrado) e a variância exponencial
+ * do ruído em torno dele. A derivada é medida sobre uma janela fixa de
+ * tempo, e não entre duas leituras: dividir pelo intervalo entre leituras
+ * faz o ruído parecer maior quanto mais rápido se lê, e o sensor nunca
+ * sairia do intervalo mínimo.
+ *
+ * O sinal é considerado "em mudança" se a derivada ou o desvio passar do
+ * limite. Para voltar a "estável" os dois precisam cair abaixo de
+ * CHANGE_HYSTERESIS x o limite, para não alternar no limiar.
+ */
+class ChangeDetector
+{
+public:
+    /**
+     * @param rate_threshold Variação do sinal filtrado (unidades por segundo).
+     * @param noise_threshold Desvio padrão (unidades) em torno do filtrado.
+     * @param window_ms Janela da derivada. Deve cobrir várias leituras no
+     * intervalo mínimo do sensor.
+     * @param alpha Peso da leitura nova na média exponencial (0-1).
+     */
+    ChangeDetector(float rate_threshold, float noise_threshold, unsigned long window_ms, float alpha = 0.3f);
+
+    /**
+     * @brief Alimenta uma leitura válida.
+     * @param dt_ms Tempo desde a leitura anterior.
+     * @return true se o sinal está mudando.
+     */
+    bool update(float value, unsigned long dt_ms);
+
+    float filtered() const { return _filtered; }
+
+private:
+    float _rateThreshold;
+    float _noiseThreshold;
+    unsigned long _window;
+    float _alpha;
+    float _filtered;
+    float _variance;
+    float _windowStart; // Filtrado no início da janela atual
+    unsigned long _windowElapsed; // ms desde o início da janela
+    bool _moving; // Última decisão da derivada
+    bool _noisy; // Última decisão do desvio
+    bool _primed;
+};
+
+/**
+ * Agenda as leituras de um sensor.
+ *
+ * Lê no intervalo mínimo enquanto há mudança e dobra o intervalo a cada
+ * leitura estável, até o máximo.
+ */
+class AdaptiveSampler
+{
+public:
+    /**
+     * @param min_interval Intervalo mínimo (ms). Para o DHT, respeitar o
+     * tempo mínimo entre leituras do sensor.
+     * @param max_interval Intervalo máximo (ms) quando tudo está estável.
+     */
+    AdaptiveSampler(unsigned long min_interval, unsigned long max_interval);
+
+    /**
+     * @brief true se já está na hora da próxima leitura.
+     */
+    bool due(unsigned long now) const { return now - _lastRead >= _interval; }
+
+    /**
+     * @brief Registra a leitura feita agora e calcula o próximo intervalo.
+     * @param active true se o sinal está mudando. Uma leitura que falhou
+     * não é mudança: passar false deixa o sensor recuar.
+     */
+    void schedule(bool active, unsigned long now);
+
+    unsigned long interval() const { return _interval; }
+
+    /**
+     * @brief Tempo (ms) desde a leitura anterior, para o ChangeDetector.
+     */
+    unsigned long elapsed(unsigned long now) const { return now - _lastRead; }
+
+private:
+    unsigned long _minInterval;
+    unsigned long _maxInterval;
+    unsigned long _interval;
+    unsigned long _lastRead;
+};
+
+#endif // ADAPTIVE_SAMPLER_H
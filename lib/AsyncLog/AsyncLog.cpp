@@ -0,0 +1,133 @@
+#include "AsyncLog.h"
+
+RingbufHandle_t AsyncLog::_ring = nullptr;
+volatile uint32_t AsyncLog::_dropped = 0;
+#if LOG_TAIL_SIZE > 0
+char AsyncLog::_tail[LOG_TAIL_SIZE];
+size_t AsyncLog::_tailPos = 0;
+bool AsyncLog::_tailFull = false;
+portMUX_TYPE AsyncLog::_tailMux = portMUX_INITIALIZER_UNLOCKED;
+#endif
+
+void AsyncLog::begin(UBaseType_t priority)
+{
+    if (_ring != nullptr)
+        return;
+
+    _ring = xRingbufferCreate(LOG_BUFFER_SIZE, RINGBUF_TYPE_BYTEBUF);
+    if (_ring == nullptr)
+    {
+        Serial.println("[Log] Sem memoria para o buffer. Usando a serial direto.");
+        return;
+    }
+
+    // Núcleo 0, longe do loop() do Arduino (núcleo 1)
+    xTaskCreatePinnedToCore(drainTask, "log", 3072, nullptr, priority, nullptr, 0);
+}
+
+void AsyncLog::write(const char *format, ...)
+{
+    char line[LOG_LINE_SIZE];
+    va_list args;
+    va_start(args, format);
+    int len = vsnprintf(line, sizeof(line), format, args);
+    va_end(args);
+
+    if (len <= 0)
+        return;
+    if ((size_t)len >= sizeof(line))
+        len = sizeof(line) - 1; // Mensagem truncada
+
+    appendTail(line, len);
+
+    if (_ring == nullptr)
+    {
+        Serial.write((const uint8_t *)line, len);
+        return;
+    }
+
+    // Nunca espera: se o buffer estiver cheio, descarta
+    if (xRingbufferSend(_ring, line, len, 0) != pdTRUE)
+    {
+        _dropped = _dropped + 1;
+    }
+}
+
+void AsyncLog::flush(unsigned long timeout_ms)
+{
+    if (_ring == nullptr)
+        return;
+
+    unsigned long start = millis();
+    UBaseType_t waiting = 1;
+    while (millis() - start < timeout_ms)
+    {
+        vRingbufferGetInfo(_ring, nullptr, nullptr, nullptr, nullptr, &waiting);
+        if (waiting == 0)
+            break;
+        delay(5);
+    }
+    Serial.flush();
+}
+
+size_t AsyncLog::tail(char *out, size_t size)
+{
+    if (size == 0)
+        return 0;
+
+#if LOG_TAIL_SIZE > 0
+    size_t len = 0;
+    portENTER_CRITICAL(&_tailMux);
+    // Parte mais antiga (depois da posição atual) e depois a mais nova
+    if (_tailFull)
+    {
+        size_t n = min(LOG_TAIL_SIZE - _tailPos, size - 1);
+        memcpy(out, _tail + _tailPos, n);
+        len = n;
+    }
+    size_t n = min(_tailPos, size - 1 - len);
+    memcpy(out + len, _tail, n);
+    len += n;
+    portEXIT_CRITICAL(&_tailMux);
+
+    out[len] = '\0';
+    return len;
+#else
+    out[0] = '\0';
+    return 0;
+#endif
+}
+
+// --- Funções Privadas ---
+
+void AsyncLog::drainTask(void *arg)
+{
+    while (true)
+    {
+        size_t size = 0;
+        uint8_t *data = (uint8_t *)xRingbufferReceiveUpTo(_ring, &size, portMAX_DELAY, 128);
+        if (data != nullptr)
+        {
+            // Só esta tarefa fica esperando a UART
+            Serial.write(data, size);
+            vRingbufferReturnItem(_ring, data);
+        }
+    }
+}
+
+void AsyncLog::appendTail(const char *text, size_t len)
+{
+#if LOG_TAIL_SIZE > 0
+    portENTER_CRITICAL(&_tailMux);
+    for (size_t i = 0; i < len; i++)
+    {
+        _tail[_tailPos++] = text[i];
+        if (_tailPos == LOG_TAIL_SIZE)
+        {
+            _tailPos = 0;
+            _tailFull = true;
+        }
+    }
+    portEXIT_CRITICAL(&_tailMux);
+#endif
+}
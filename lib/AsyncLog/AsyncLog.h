@@ -0,0 +1,91 @@
+#ifndef ASYNC_LOG_H
+#define ASYNC_LOG_H
+
+#include <Arduino.h>
+#include <freertos/ringbuf.h>
+
+#define LOG_LEVEL_NONE 0
+#define LOG_LEVEL_ERROR 1
+#define LOG_LEVEL_WARN 2
+#define LOG_LEVEL_INFO 3
+#define LOG_LEVEL_DEBUG 4
+
+// Nível máximo compilado. Ex: -DLOG_LEVEL=LOG_LEVEL_WARN no platformio.ini
+// remove do binário todas as mensagens de INFO e DEBUG.
+#ifndef LOG_LEVEL
+#define LOG_LEVEL LOG_LEVEL_INFO
+#endif
+
+// Buffer entre quem loga e a tarefa que escreve na serial (bytes)
+#ifndef LOG_BUFFER_SIZE
+#define LOG_BUFFER_SIZE 4096
+#endif
+
+// Últimos bytes guardados para o GET /log. 0 desativa o endpoint.
+#ifndef LOG_TAIL_SIZE
+#define LOG_TAIL_SIZE 2048
+#endif
+
+// Tamanho máximo de uma mensagem formatada
+#ifndef LOG_LINE_SIZE
+#define LOG_LINE_SIZE 256
+#endif
+
+#define LOG_AT(level, ...)                         \
+    do                                             \
+    {                                              \
+        if (LOG_LEVEL >= (level))                  \
+            AsyncLog::write(__VA_ARGS__);          \
+    } while (0)
+
+#define LOG_E(...) LOG_AT(LOG_LEVEL_ERROR, __VA_ARGS__)
+#define LOG_W(...) LOG_AT(LOG_LEVEL_WARN, __VA_ARGS__)
+#define LOG_I(...) LOG_AT(LOG_LEVEL_INFO, __VA_ARGS__)
+#define LOG_D(...) LOG_AT(LOG_LEVEL_DEBUG, __VA_ARGS__)
+
+/**
+ * Log que não bloqueia quem chama.
+ *
+ * A mensagem é formatada num buffer da pilha e copiada para um ring buffer;
+ * uma tarefa de baixa prioridade escreve na serial. Se o buffer estiver
+ * cheio a mensagem é descartada (e contada) em vez de segurar o loop.
+ */
+class AsyncLog
+{
+public:
+    /**
+     * @brief Cria o buffer e a tarefa de escrita. Chamar depois do Serial.begin().
+     * Antes disso, as mensagens vão direto para a serial.
+     */
+    static void begin(UBaseType_t priority = 1);
+
+    static void write(const char *format, ...) __attribute__((format(printf, 1, 2)));
+
+    /**
+     * @brief Espera o buffer esvaziar (ex: antes de um ESP.restart()).
+     */
+    static void flush(unsigned long timeout_ms = 1000);
+
+    /**
+     * @brief Copia as últimas mensagens (ordem cronológica) para out.
+     * @return Quantidade de bytes copiados (sem o '\0').
+     */
+    static size_t tail(char *out, size_t size);
+
+    static uint32_t dropped() { return _dropped; }
+
+private:
+    static void drainTask(void *arg);
+    static void appendTail(const char *text, size_t len);
+
+    static RingbufHandle_t _ring;
+    static volatile uint32_t _dropped;
+#if LOG_TAIL_SIZE > 0
+    static char _tail[LOG_TAIL_SIZE];
+    static size_t _tailPos;
+    static bool _tailFull;
+    static portMUX_TYPE _tailMux;
+#endif
+};
+
+#endif // ASYNC_LOG_H
@@ -1,9 +1,16 @@
 #include "DashboardServer.h"
 #include "time.h" // Para buscar a hora NTP
+#include <algorithm>
+#include <errno.h>
+#include <mbedtls/base64.h>
+#include <limits>
 // ... (includes da biblioteca) ...
 
+// A página é montada em tempo de compilação: o cartão e o script do envio
+// de firmware só entram se o perfil tiver OTA (como a rota /update)
+
 // ATUALIZADO: 'Luminosidade (raw)' e 'lux' para '(0-4095)'
-const char *DashboardServer::_dashboard_html = R"EOF(
+#define DASHBOARD_HTML_HEAD R"EOF(
 <!DOCTYPE html>
 <html>
 <head>
@@ -73,7 +80,32 @@ const char *DashboardServer::_dashboard_html = R"EOF(
                 <h2 style="color:#f0ad4e">Luminosidade (0-4095)</h2>
                 <div id="luminosidade" class="data">----</div>
             </div>
+)EOF"
 
+#define DASHBOARD_HTML_UPDATE_CARD R"EOF(
+            <div id="update-card" class="card">
+                <h2 style="color:#777">Atualizar Firmware</h2>
+                <form id="formUpdate">
+                    <div class="form-group">
+                        <input type="file" id="firmware" name="firmware" accept=".bin,.zz,.zlib,.delta" required>
+                    </div>
+                    <div class="form-group">
+                        <label for="md5">MD5 da imagem final:</label>
+                        <input type="text" id="md5" name="md5" minlength="32" maxlength="32" required>
+                    </div>
+                    <div class="form-group">
+                        <label for="senhaAdmin">Senha do administrador:</label>
+                        <input type="password" id="senhaAdmin" required>
+                    </div>
+                    <div class="form-group">
+                        <span id="updateStatus"></span>
+                        <button type="submit">Enviar</button>
+                    </div>
+                </form>
+            </div>
+)EOF"
+
+#define DASHBOARD_HTML_SCRIPT R"EOF(
         </div>
     </div>
     
@@ -93,11 +125,12 @@ const char *DashboardServer::_dashboard_html = R"EOF(
                     document.getElementById('date').innerText = data.date;
                     document.getElementById('time').innerText = data.time;
                     
-                    document.getElementById('temperatura').innerHTML = parseFloat(data.temperatura).toFixed(1) + ' &deg;C';
-                    document.getElementById('humidade').innerHTML = parseFloat(data.humidade).toFixed(1) + ' %';
+                    // null: a placa não tem o sensor, ou ainda não leu
+                    document.getElementById('temperatura').innerHTML = data.temperatura == null ? '-- &deg;C' : parseFloat(data.temperatura).toFixed(1) + ' &deg;C';
+                    document.getElementById('humidade').innerHTML = data.humidade == null ? '-- %' : parseFloat(data.humidade).toFixed(1) + ' %';
                     
                     // ATUALIZADO: Removemos o 'lux' e mostramos o valor raw
-                    document.getElementById('luminosidade').innerHTML = parseInt(data.luminosidade);
+                    document.getElementById('luminosidade').innerHTML = data.luminosidade == null ? '--' : parseInt(data.luminosidade);
 
                     document.getElementById('horaLigar').value = data.hora_ligar;
                     document.getElementById('horaDesligar').value = data.hora_desligar;
@@ -112,7 +145,8 @@ const char *DashboardServer::_dashboard_html = R"EOF(
             e.preventDefault(); 
             fetch('/settings', {
                 method: 'POST',
-                body: new FormData(this)
+                // urlencoded (não multipart): o mesmo corpo serve ao HTTP e ao HTTPS
+                body: new URLSearchParams(new FormData(this))
             })
             .then(response => {
                 if(response.ok) {
@@ -122,35 +156,153 @@ const char *DashboardServer::_dashboard_html = R"EOF(
                 }
             });
         });
+)EOF"
+
+#define DASHBOARD_HTML_UPDATE_SCRIPT R"EOF(
+        // Envio do firmware (.bin, zlib ou patch gerado pelo tools/ota_delta)
+        document.getElementById('formUpdate').addEventListener('submit', function(e) {
+            e.preventDefault();
+            var status = document.getElementById('updateStatus');
+            // HTTPS: a imagem crua no corpo. HTTP: multipart (upload do WebServer)
+            var data = document.getElementById('firmware').files[0];
+            if (location.protocol !== 'https:') {
+                data = new FormData();
+                data.append('firmware', document.getElementById('firmware').files[0]);
+            }
+            status.innerText = 'Enviando...';
+            fetch('/update?md5=' + encodeURIComponent(document.getElementById('md5').value), {
+                method: 'POST',
+                headers: { 'Authorization': 'Basic ' + btoa('admin:' + document.getElementById('senhaAdmin').value) },
+                body: data
+            })
+            .then(response => response.text().then(text => {
+                status.innerText = text;
+            }))
+            .catch(error => { status.innerText = 'Erro no envio.'; });
+        });
+)EOF"
 
+#define DASHBOARD_HTML_END R"EOF(
         fetchData();
         setInterval(fetchData, 5000); // Intervalo de atualização
     </script>
 </body>
 </html>
-)EOF";
+)EOF"
+
+const char *DashboardServer::_dashboard_html =
+    ActiveBoard::has(FEATURE_OTA)
+        ? DASHBOARD_HTML_HEAD DASHBOARD_HTML_UPDATE_CARD DASHBOARD_HTML_SCRIPT DASHBOARD_HTML_UPDATE_SCRIPT DASHBOARD_HTML_END
+        : DASHBOARD_HTML_HEAD DASHBOARD_HTML_SCRIPT DASHBOARD_HTML_END;
 
-// ... (resto do ficheiro DashboardServer.cpp) ...
-// Nenhuma outra mudança é necessária neste ficheiro.
+/**
+ * Junta o texto em pedaços e envia cada um com sendContent()
+ * (resposta com Transfer-Encoding: chunked).
+ */
+class ChunkedPrint : public Print
+{
+public:
+    ChunkedPrint(WebServer &server) : _server(server), _len(0) {}
+    ~ChunkedPrint() { flush(); }
 
-DashboardServer::DashboardServer(int port) : _server(port)
+    size_t write(uint8_t c) override
+    {
+        if (_len == sizeof(_buf))
+            flush();
+        _buf[_len++] = c;
+        return 1;
+    }
+
+    void flush() override
+    {
+        if (_len > 0)
+            _server.sendContent(_buf, _len);
+        _len = 0;
+    }
+
+private:
+    WebServer &_server;
+    char _buf[512];
+    size_t _len;
+};
+
+/**
+ * Lê um número inteiro da URL (sem sobras e sem estourar o tipo).
+ */
+template <typename T>
+static bool parseInteger(const char *text, T &out)
+{
+    char *end;
+    errno = 0;
+    long long value = strtoll(text, &end, 10);
+    if (end == text || *end != '\0' || errno == ERANGE ||
+        value < (long long)std::numeric_limits<T>::min() || value > (long long)std::numeric_limits<T>::max())
+    {
+        return false;
+    }
+    out = (T)value;
+    return true;
+}
+
+DashboardServer::DashboardServer(int port)
+    : _server(port), _arena(_arenaBuffer, sizeof(_arenaBuffer))
 {
     _dataCallback = nullptr;
     _settingsCallback = nullptr;
+    _historyCallback = nullptr;
+    _updateOk = false;
+    _updateDenied = false;
+    _adminPassword[0] = '\0';
+    _deviceId[0] = '\0';
+    _httpsPort = 0;
 }
 
 void DashboardServer::begin()
 {
-    _server.on("/", HTTP_GET, std::bind(&DashboardServer::handleRoot, this));
+    if (_httpsPort != 0)
+    {
+        // Com TLS, senha e configurações só trafegam cifradas: a página e
+        // as rotas que mudam o estado ficam só no HTTPS
+        _server.on("/", HTTP_GET, std::bind(&DashboardServer::handleRedirect, this));
+        _server.onNotFound(std::bind(&DashboardServer::handleRedirect, this));
+    }
+    else
+    {
+        _server.on("/", HTTP_GET, std::bind(&DashboardServer::handleRoot, this));
+        _server.on("/settings", HTTP_POST, std::bind(&DashboardServer::handleSettings, this));
+    }
     _server.on("/data.json", HTTP_GET, std::bind(&DashboardServer::handleDataJson, this));
-    _server.on("/settings", HTTP_POST, std::bind(&DashboardServer::handleSettings, this));
+
+    // Rotas opcionais: só entram no binário se o perfil da placa tiver a funcionalidade
+    if constexpr (ActiveBoard::has(FEATURE_OTA))
+    {
+        if (_httpsPort == 0)
+        {
+            _server.on("/update", HTTP_POST,
+                       std::bind(&DashboardServer::handleUpdateDone, this),
+                       std::bind(&DashboardServer::handleUpdateUpload, this));
+        }
+    }
+    if constexpr (ActiveBoard::has(FEATURE_HISTORY))
+    {
+        _server.on("/history.json", HTTP_GET, std::bind(&DashboardServer::handleHistory, this));
+    }
+    if constexpr (ActiveBoard::has(FEATURE_TRACE))
+    {
+        _server.on("/trace.json", HTTP_GET, std::bind(&DashboardServer::handleTrace, this));
+    }
+#if LOG_TAIL_SIZE > 0
+    _server.on("/log", HTTP_GET, std::bind(&DashboardServer::handleLog, this));
+#endif
     _server.begin();
-    Serial.println("Servidor de Dashboard iniciado!");
+    LOG_I("Servidor de Dashboard iniciado!\n");
 }
 
 void DashboardServer::loop()
 {
     _server.handleClient();
+    // Tudo o que a requisição alocou no arena é liberado de uma vez
+    _arena.reset();
 }
 
 void DashboardServer::onDataRequest(DataCallback callback)
@@ -163,16 +315,29 @@ void DashboardServer::onSettingsRequest(SettingsCallback callback)
     _settingsCallback = callback;
 }
 
-// --- Handlers Privados ---
+void DashboardServer::onHistoryRequest(HistoryCallback callback)
+{
+    _historyCallback = callback;
+}
 
-void DashboardServer::handleRoot()
+void DashboardServer::setAdminPassword(const char *password)
 {
-    _server.send(200, "text/html", _dashboard_html);
+    strlcpy(_adminPassword, password, sizeof(_adminPassword));
 }
 
-void DashboardServer::handleDataJson()
+void DashboardServer::setDeviceId(const char *id)
+{
+    strlcpy(_deviceId, id, sizeof(_deviceId));
+}
+
+void DashboardServer::redirectToHttps(uint16_t port)
 {
-    StaticJsonDocument<512> doc;
+    _httpsPort = port;
+}
+
+size_t DashboardServer::renderData(char *out, size_t size)
+{
+    JsonDocument doc(&_arena);
 
     // 1. Hora
     struct tm timeinfo;
@@ -188,6 +353,10 @@ void DashboardServer::handleDataJson()
         strcpy(dateStr, "Sincronizando...");
         strcpy(timeStr, "--:--:--");
     }
+    if (_deviceId[0] != '\0')
+    {
+        doc["id"] = _deviceId;
+    }
     doc["date"] = dateStr;
     doc["time"] = timeStr;
 
@@ -207,33 +376,260 @@ void DashboardServer::handleDataJson()
         doc["hora_desligar"] = "00:00";
     }
 
-    String output;
-    serializeJson(doc, output);
+    // 3. Serializa num buffer fixo (sem String)
+    if (doc.overflowed() || measureJson(doc) >= size)
+    {
+        return 0;
+    }
+    return serializeJson(doc, out, size);
+}
+
+bool DashboardServer::applySettings(const char *ligar, const char *desligar, int luzMaxima)
+{
+    if (_settingsCallback == nullptr)
+        return false;
+
+    _settingsCallback(ligar, desligar, luzMaxima);
+    return true;
+}
+
+bool DashboardServer::checkAdminAuthorization(const char *authorization) const
+{
+    if (_adminPassword[0] == '\0' || authorization == nullptr || strncmp(authorization, "Basic ", 6) != 0)
+        return false;
+
+    // "admin:senha" em base64
+    unsigned char decoded[sizeof(_adminPassword) + 16];
+    size_t length = 0;
+    const char *encoded = authorization + 6;
+    if (mbedtls_base64_decode(decoded, sizeof(decoded) - 1, &length, (const unsigned char *)encoded, strlen(encoded)) != 0)
+        return false;
+    decoded[length] = '\0';
+
+    size_t userLength = strlen(ADMIN_USER);
+    const char *text = (const char *)decoded;
+    if (length != userLength + 1 + strlen(_adminPassword) || strncmp(text, ADMIN_USER, userLength) != 0 ||
+        text[userLength] != ':')
+        return false;
+
+    // Comparação em tempo constante: não revela quantos caracteres acertou
+    const char *password = text + userLength + 1;
+    uint8_t diff = 0;
+    for (size_t i = 0; _adminPassword[i] != '\0'; i++)
+        diff |= (uint8_t)(password[i] ^ _adminPassword[i]);
+    return diff == 0;
+}
+
+// --- Handlers Privados ---
+
+void DashboardServer::handleRoot()
+{
+    TraceSpan span(TRACE_ROUTE_ROOT);
+    _server.send(200, "text/html", _dashboard_html);
+}
+
+// 301 para a mesma rota no HTTPS, no mesmo host que o navegador usou
+void DashboardServer::handleRedirect()
+{
+    String host = _server.hostHeader();
+    int colon = host.indexOf(':');
+    if (colon >= 0)
+        host.remove(colon); // Tira a porta do HTTP
+    if (host.length() == 0)
+        host = WiFi.localIP().toString();
+
+    char location[160];
+    if (_httpsPort == 443)
+        snprintf(location, sizeof(location), "https://%s%s", host.c_str(), _server.uri().c_str());
+    else
+        snprintf(location, sizeof(location), "https://%s:%u%s", host.c_str(), _httpsPort, _server.uri().c_str());
+
+    _server.sendHeader("Location", location);
+    _server.send(301, "text/plain", "");
+}
+
+void DashboardServer::handleDataJson()
+{
+    TraceSpan span(TRACE_ROUTE_DATA);
+
+    char output[JSON_RESPONSE_SIZE];
+    if (renderData(output, sizeof(output)) == 0)
+    {
+        _server.send(500, "text/plain", "Resposta muito grande");
+        return;
+    }
     _server.send(200, "application/json", output);
 }
 
 // ATUALIZADO: Handler para o POST /settings
 void DashboardServer::handleSettings()
 {
+    TraceSpan span(TRACE_ROUTE_SETTINGS);
     // Verifica os 3 argumentos com os nomes atualizados
-    if (_settingsCallback &&
-        _server.hasArg("ligar") &&
+    if (_server.hasArg("ligar") &&
         _server.hasArg("desligar") &&
         _server.hasArg("luzMaxima"))
     { // Argumento atualizado
 
-        // Pega os valores
-        String ligar = _server.arg("ligar");
-        String desligar = _server.arg("desligar");
-        int luzMaxima = _server.arg("luzMaxima").toInt(); // Argumento atualizado
+        // Pega os valores (sem copiar: apontam para a requisição)
+        ArgView ligar = _server.argView("ligar");
+        ArgView desligar = _server.argView("desligar");
+        int luzMaxima = _server.argView("luzMaxima").toInt(); // Argumento atualizado
 
         // Chama o callback no main.cpp
-        _settingsCallback(ligar, desligar, luzMaxima);
+        if (applySettings(ligar.data, desligar.data, luzMaxima))
+        {
+            _server.send(200, "text/plain", "OK");
+            return;
+        }
+    }
+    _server.send(400, "text/plain", "Bad Request");
+}
 
-        _server.send(200, "text/plain", "OK");
+// Handler para o POST /update (chamado depois que o upload terminou)
+void DashboardServer::handleUpdateDone()
+{
+    TraceSpan span(TRACE_ROUTE_UPDATE);
+    if (_updateDenied)
+    {
+        // Sem WWW-Authenticate: a página manda a senha, o navegador não deve abrir o diálogo
+        if (_adminPassword[0] == '\0')
+            _server.send(403, "text/plain", "OTA desativado: defina a senha de administrador no portal");
+        else
+            _server.send(401, "text/plain", "Senha de administrador invalida");
+        return;
+    }
+    if (_updateOk)
+    {
+        _server.send(200, "text/plain", "OK. Reiniciando...");
+        LOG_I("[OTA] Nova imagem aceita. Reiniciando em 1 segundo...\n");
+        delay(1000);
+        AsyncLog::flush();
+        ESP.restart();
     }
     else
+    {
+        const char *error = _ota.lastError();
+        _server.send(400, "text/plain", error != nullptr ? error : "Falha na atualizacao");
+    }
+}
+
+// Recebe a imagem em pedaços e grava direto no slot OTA inativo
+void DashboardServer::handleUpdateUpload()
+{
+    HTTPUpload &upload = _server.upload();
+
+    switch (upload.status)
+    {
+    case UPLOAD_FILE_START:
+        // A senha é conferida antes de abrir o slot OTA; sem senha no NVS não há OTA
+        _updateDenied = _adminPassword[0] == '\0' || !_server.authenticate(ADMIN_USER, _adminPassword);
+        if (_updateDenied)
+        {
+            _updateOk = false;
+            LOG_W("[OTA] Upload recusado: senha de administrador ausente ou invalida.\n");
+            break;
+        }
+        LOG_I("[OTA] Recebendo %s...\n", upload.filename.c_str());
+        // O MD5 (obrigatório) vem na query string (?md5=...)
+        _updateOk = _ota.begin(_server.argView("md5").data);
+        break;
+
+    case UPLOAD_FILE_WRITE:
+        if (_updateOk)
+        {
+            _updateOk = _ota.write(upload.buf, upload.currentSize);
+        }
+        break;
+
+    case UPLOAD_FILE_END:
+        if (_updateOk)
+        {
+            _updateOk = _ota.end();
+            LOG_I("[OTA] %u bytes recebidos, %u gravados (%s).\n",
+                  (unsigned)_ota.bytesReceived(), (unsigned)_ota.bytesWritten(),
+                  _ota.isDelta() ? "patch" : _ota.isCompressed() ? "zlib" : "binario");
+        }
+        if (!_updateOk)
+        {
+            LOG_W("[OTA] Falha: %s\n", _ota.lastError());
+        }
+        break;
+
+    case UPLOAD_FILE_ABORTED:
+        _ota.abort();
+        _updateOk = false;
+        LOG_W("[OTA] Upload interrompido.\n");
+        break;
+    }
+}
+
+// Handler para o GET /history.json?from=...&to=...&step=... (segundos, epoch)
+// Padrão: últimas 24 h, um ponto por hora.
+void DashboardServer::handleHistory()
+{
+    TraceSpan span(TRACE_ROUTE_HISTORY);
+
+    if (_historyCallback == nullptr)
+    {
+        _server.send(404, "text/plain", "Historico indisponivel");
+        return;
+    }
+
+    ArgView fromArg = _server.argView("from");
+    ArgView toArg = _server.argView("to");
+    ArgView stepArg = _server.argView("step");
+
+    // Valores fora do tipo, com sobras, passo 0 ou from > to: 400
+    time_t to = time(nullptr);
+    long long step = 3600;
+    bool ok = (!toArg.valid() || parseInteger(toArg.data, to)) &&
+              (!stepArg.valid() || parseInteger(stepArg.data, step));
+    time_t from = (time_t)std::max<long long>((long long)to - 86400, std::numeric_limits<time_t>::min());
+    ok = ok && (!fromArg.valid() || parseInteger(fromArg.data, from));
+    if (!ok || from > to || step <= 0 || step > UINT32_MAX)
     {
         _server.send(400, "text/plain", "Bad Request");
+        return;
     }
-}
\ No newline at end of file
+
+    _server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+    _server.send(200, "application/json", "");
+    {
+        ChunkedPrint out(_server);
+        _historyCallback(out, from, to, (uint32_t)step);
+    }
+    _server.sendContent(""); // Fim da resposta chunked
+}
+
+// Handler para o GET /trace.json (abre no chrome://tracing ou ui.perfetto.dev)
+void DashboardServer::handleTrace()
+{
+    TraceSpan span(TRACE_ROUTE_TRACE);
+
+    _server.sendHeader("Content-Disposition", "attachment; filename=trace.json");
+    _server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+    _server.send(200, "application/json", "");
+    {
+        ChunkedPrint out(_server);
+        EventTracer::dumpChromeTrace(out);
+    }
+    _server.sendContent(""); // Fim da resposta chunked
+}
+
+#if LOG_TAIL_SIZE > 0
+// Handler para o GET /log (últimas mensagens do log)
+void DashboardServer::handleLog()
+{
+    TraceSpan span(TRACE_ROUTE_LOG);
+
+    char *text = (char *)_arena.allocate(LOG_TAIL_SIZE + 1);
+    if (text == nullptr)
+    {
+        _server.send(500, "text/plain", "Sem memoria");
+        return;
+    }
+    AsyncLog::tail(text, LOG_TAIL_SIZE + 1);
+    _server.send(200, "text/plain; charset=utf-8", text);
+}
+#endif
@@ -4,13 +4,24 @@
 #include <Arduino.h>
 #include <WebServer.h>
 #include <ArduinoJson.h>
-#include <functional> // Para std::function (callbacks)
+#include "OtaUpdater.h"
+#include "RequestArena.h"
+#include "ArgWebServer.h"
+#include "EventTracer.h"
+#include "AsyncLog.h"
+#include <functional> // Para std::bind (rotas do WebServer)
+#include "BoardProfile.h"
 
-typedef std::function<void(JsonDocument &doc)> DataCallback;
+// Os callbacks são ponteiros de função: a chamada é direta, sem std::function.
+typedef void (*DataCallback)(JsonDocument &doc);
 
 // ATUALIZADO: Callback para RECEBER dados (Web -> ESP32)
 // Trocamos 'aceleracao' por 'luzMaxima'
-typedef std::function<void(String ligar, String desligar, int luzMaxima)> SettingsCallback;
+// Os textos apontam para a requisição atual: copie-os se precisar guardá-los.
+typedef void (*SettingsCallback)(const char *ligar, const char *desligar, int luzMaxima);
+
+// Callback para o histórico: escreve o JSON de [from, to] direto na resposta.
+typedef void (*HistoryCallback)(Print &out, time_t from, time_t to, uint32_t step);
 
 class DashboardServer
 {
@@ -25,14 +36,98 @@ public:
      */
     void onSettingsRequest(SettingsCallback callback);
 
+    /**
+     * @brief Registra a função que responde o GET /history.json.
+     */
+    void onHistoryRequest(HistoryCallback callback);
+
+    /**
+     * @brief Define a senha do usuário "admin", exigida no POST /update.
+     * Senha vazia desativa o OTA.
+     */
+    void setAdminPassword(const char *password);
+
+    /**
+     * @brief Define o id enviado no campo "id" do /data.json (8 dígitos
+     * hexadecimais, o mesmo do beacon).
+     */
+    void setDeviceId(const char *id);
+
+    /**
+     * @brief Com o HTTPS no ar: a porta 80 deixa de aceitar /settings e
+     * /update e manda a página (e qualquer rota desconhecida) para o HTTPS
+     * com 301. As rotas só de leitura (/data.json, /history.json, ...)
+     * continuam no HTTP para o coletor. Chamar antes de begin().
+     */
+    void redirectToHttps(uint16_t port);
+
+    // --- Lógica das rotas, compartilhada com o SecureDashboard (HTTPS) ---
+    // Chamar só no loop principal: usam o arena e os callbacks do sketch.
+
+    /**
+     * @brief Monta o JSON do /data.json (hora + dados do DataCallback).
+     * @return Tamanho escrito em 'out', ou 0 se não coube.
+     */
+    size_t renderData(char *out, size_t size);
+
+    /**
+     * @brief Aplica um POST /settings.
+     * @return false se não há callback registrado.
+     */
+    bool applySettings(const char *ligar, const char *desligar, int luzMaxima);
+
+    /**
+     * @brief true se há senha de administrador (sem ela o OTA fica desligado).
+     */
+    bool otaEnabled() const { return _adminPassword[0] != '\0'; }
+
+    /**
+     * @brief Confere um cabeçalho "Authorization: Basic ..." contra o
+     * usuário admin e a senha definida em setAdminPassword().
+     */
+    bool checkAdminAuthorization(const char *authorization) const;
+
+    static const char *dashboardHtml() { return _dashboard_html; }
+
+    // Maior uso do arena por requisição (relatório de memória no status)
+    size_t arenaPeak() const { return _arena.peak(); }
+    static size_t arenaSize() { return ARENA_SIZE; }
+
+    // Tamanho máximo da resposta do /data.json
+    static const size_t JSON_RESPONSE_SIZE = 512;
+
 private:
     void handleRoot();
     void handleDataJson();
     void handleSettings();
+    void handleUpdateDone();
+    void handleUpdateUpload();
+    void handleTrace();
+    void handleHistory();
+    void handleRedirect();
+#if LOG_TAIL_SIZE > 0
+    void handleLog();
+#endif
 
-    WebServer _server;
+    ArgWebServer _server;
     DataCallback _dataCallback;
     SettingsCallback _settingsCallback; // ATUALIZADO: Tipo de callback
+    HistoryCallback _historyCallback;
+
+    // --- Atualização OTA (/update) ---
+    static constexpr const char *ADMIN_USER = "admin";
+    OtaUpdater _ota;
+    bool _updateOk;
+    bool _updateDenied;
+    char _adminPassword[33];
+
+    char _deviceId[9]; // "id" do /data.json (vazio: não enviado)
+    uint16_t _httpsPort; // != 0: a porta 80 só redireciona (redirectToHttps)
+
+    // --- Memória por requisição (liberada a cada loop()) ---
+    static const size_t ARENA_SIZE = 4096;
+    uint8_t _arenaBuffer[ARENA_SIZE];
+    RequestArena _arena;
 
     static const char *_dashboard_html;
 };
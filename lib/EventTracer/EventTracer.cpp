@@ -0,0 +1,115 @@
+#include "EventTracer.h"
+
+TraceEvent EventTracer::_ring[portNUM_PROCESSORS][TRACE_RING_SIZE];
+uint32_t EventTracer::_head[portNUM_PROCESSORS];
+
+// Nomes usados no arquivo de trace (mesma ordem dos enums)
+static const char *SENSOR_NAMES[] = {"temperatura", "humidade", "luminosidade"};
+static const char *ROUTE_NAMES[] = {"GET /", "GET /data.json", "POST /settings", "POST /update", "GET /trace.json", "GET /log", "GET /history.json"};
+static const char *WIFI_NAMES[] = {"conectado", "conexao perdida", "reconectando", "modo AP"};
+
+template <size_t N>
+static const char *nameOf(const char *(&names)[N], uint16_t index)
+{
+    return index < N ? names[index] : "?";
+}
+
+void EventTracer::dumpChromeTrace(Print &out)
+{
+    const double cyclesPerUs = getCpuFrequencyMhz();
+    const double cyclesPerTick = cyclesPerUs * 1000.0 * portTICK_PERIOD_MS;
+    bool first = true;
+
+    out.print("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+
+    for (int core = 0; core < portNUM_PROCESSORS; core++)
+    {
+        uint32_t head = __atomic_load_n(&_head[core], __ATOMIC_RELAXED);
+        uint32_t count = head < TRACE_RING_SIZE ? head : TRACE_RING_SIZE;
+
+        TraceEvent prev;
+        double ts = 0;
+
+        for (uint32_t i = head - count; i != head; i++)
+        {
+            TraceEvent event = _ring[core][i & (TRACE_RING_SIZE - 1)];
+
+            // Tempo em us: o primeiro evento usa o tick; os seguintes somam a
+            // diferença de CCOUNT, corrigida pelas voltas que o tick indica.
+            if (i == head - count)
+            {
+                ts = (double)event.ticks * portTICK_PERIOD_MS * 1000.0;
+            }
+            else
+            {
+                double expected = (double)(uint32_t)(event.ticks - prev.ticks) * cyclesPerTick;
+                double delta = (double)(uint32_t)(event.cycles - prev.cycles);
+                double wraps = floor((expected - delta) / 4294967296.0 + 0.5);
+                if (wraps < 0)
+                    wraps = 0;
+                ts += (delta + wraps * 4294967296.0) / cyclesPerUs;
+            }
+            prev = event;
+
+            if (!first)
+                out.print(",");
+            first = false;
+
+            out.printf("{\"pid\":0,\"tid\":%d,\"ts\":%.3f,", core, ts);
+            switch (event.type)
+            {
+            case TRACE_PWM_CHANGE:
+                out.printf("\"name\":\"pwm\",\"ph\":\"C\",\"args\":{\"pwm\":%d}}", (int)event.value);
+                break;
+            case TRACE_SENSOR_READ:
+                out.printf("\"name\":\"%s\",\"ph\":\"C\",\"args\":{\"valor\":%.1f}}",
+                           nameOf(SENSOR_NAMES, event.arg),
+                           event.arg == TRACE_SENSOR_LUMINOSITY ? (double)event.value : event.value / 10.0);
+                break;
+            case TRACE_SENSOR_FAIL:
+                out.printf("\"name\":\"falha %s\",\"cat\":\"sensor\",\"ph\":\"i\",\"s\":\"g\"}",
+                           nameOf(SENSOR_NAMES, event.arg));
+                break;
+            case TRACE_HTTP_BEGIN:
+            case TRACE_HTTP_END:
+                out.printf("\"name\":\"%s\",\"cat\":\"http\",\"ph\":\"%s\"}",
+                           nameOf(ROUTE_NAMES, event.arg), event.type == TRACE_HTTP_BEGIN ? "B" : "E");
+                break;
+            case TRACE_WIFI_STATE:
+                out.printf("\"name\":\"wifi %s\",\"cat\":\"wifi\",\"ph\":\"i\",\"s\":\"g\",\"args\":{\"status\":%d}}",
+                           nameOf(WIFI_NAMES, event.arg), (int)event.value);
+                break;
+            case TRACE_NTP_SYNC:
+                out.printf("\"name\":\"ntp sync\",\"cat\":\"ntp\",\"ph\":\"i\",\"s\":\"g\",\"args\":{\"minutos\":%d}}",
+                           (int)event.value);
+                break;
+            default:
+                out.printf("\"name\":\"evento %u\",\"ph\":\"i\"}", event.type);
+                break;
+            }
+        }
+    }
+
+    out.print("]}");
+}
+
+uint32_t EventTracer::benchmarkCycles(uint32_t iterations)
+{
+    uint32_t start = XTHAL_GET_CCOUNT();
+    for (uint32_t i = 0; i < iterations; i++)
+    {
+        record(TRACE_PWM_CHANGE, 0, i);
+    }
+    uint32_t elapsed = XTHAL_GET_CCOUNT() - start;
+
+    clear();
+    return elapsed / iterations;
+}
+
+void EventTracer::clear()
+{
+    for (int core = 0; core < portNUM_PROCESSORS; core++)
+    {
+        __atomic_store_n(&_head[core], 0, __ATOMIC_RELAXED);
+    }
+}
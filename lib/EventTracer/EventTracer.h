@@ -0,0 +1,130 @@
+#ifndef EVENT_TRACER_H
+#define EVENT_TRACER_H
+
+#include <Arduino.h>
+#include <xtensa/core-macros.h> // XTHAL_GET_CCOUNT()
+#include "BoardProfile.h"
+
+// Eventos guardados por núcleo (potência de 2). 16 bytes cada.
+#ifndef TRACE_RING_SIZE
+#define TRACE_RING_SIZE 256
+#endif
+static_assert(TRACE_RING_SIZE > 0 && (TRACE_RING_SIZE & (TRACE_RING_SIZE - 1)) == 0,
+              "TRACE_RING_SIZE precisa ser potencia de 2 (o indice usa a mascara TRACE_RING_SIZE - 1)");
+
+enum TraceEventType : uint8_t
+{
+    TRACE_PWM_CHANGE = 1, // value = novo PWM (0-255)
+    TRACE_SENSOR_READ,    // arg = TraceSensor, value = leitura (x10 para DHT)
+    TRACE_SENSOR_FAIL,    // arg = TraceSensor
+    TRACE_HTTP_BEGIN,     // arg = TraceRoute
+    TRACE_HTTP_END,       // arg = TraceRoute
+    TRACE_WIFI_STATE,     // arg = TraceWifiState, value = WiFi.status()
+    TRACE_NTP_SYNC,       // value = hora local em minutos
+};
+
+enum TraceSensor : uint16_t
+{
+    TRACE_SENSOR_TEMPERATURE,
+    TRACE_SENSOR_HUMIDITY,
+    TRACE_SENSOR_LUMINOSITY,
+};
+
+enum TraceRoute : uint16_t
+{
+    TRACE_ROUTE_ROOT,
+    TRACE_ROUTE_DATA,
+    TRACE_ROUTE_SETTINGS,
+    TRACE_ROUTE_UPDATE,
+    TRACE_ROUTE_TRACE,
+    TRACE_ROUTE_LOG,
+    TRACE_ROUTE_HISTORY,
+};
+
+enum TraceWifiState : uint16_t
+{
+    TRACE_WIFI_CONNECTED,
+    TRACE_WIFI_LOST,
+    TRACE_WIFI_RECONNECTING,
+    TRACE_WIFI_AP_MODE,
+};
+
+struct TraceEvent
+{
+    uint32_t cycles; // CCOUNT do núcleo (dá a volta a cada ~18 s a 240 MHz)
+    uint32_t ticks;  // Tick do FreeRTOS, usado só para desfazer as voltas do CCOUNT
+    uint8_t type;
+    uint8_t reserved;
+    uint16_t arg;
+    int32_t value;
+};
+
+/**
+ * Tracer binário de eventos, com um buffer circular por núcleo.
+ *
+ * record() não usa locks: cada núcleo só escreve no seu buffer e a posição
+ * é reservada com um incremento atômico, então tarefas e interrupções do
+ * mesmo núcleo nunca disputam o mesmo slot. Os eventos mais antigos são
+ * sobrescritos.
+ */
+class EventTracer
+{
+public:
+    static inline void record(TraceEventType type, uint16_t arg = 0, int32_t value = 0)
+    {
+        // Perfil sem trace: a chamada some e os buffers não entram no binário
+        if constexpr (ActiveBoard::has(FEATURE_TRACE))
+        {
+            uint32_t core = xPortGetCoreID();
+            uint32_t index = __atomic_fetch_add(&_head[core], 1, __ATOMIC_RELAXED);
+            TraceEvent &event = _ring[core][index & (TRACE_RING_SIZE - 1)];
+            event.cycles = XTHAL_GET_CCOUNT();
+            event.ticks = xTaskGetTickCount();
+            event.type = type;
+            event.arg = arg;
+            event.value = value;
+        }
+    }
+
+    /**
+     * @brief Escreve os eventos no formato Chrome Trace (JSON), que abre
+     * direto no chrome://tracing ou no ui.perfetto.dev.
+     */
+    static void dumpChromeTrace(Print &out);
+
+    /**
+     * @brief Mede o custo médio de record() em ciclos de CPU.
+     * Apaga o conteúdo dos buffers.
+     */
+    static uint32_t benchmarkCycles(uint32_t iterations = 1000);
+
+    static void clear();
+
+private:
+    static TraceEvent _ring[portNUM_PROCESSORS][TRACE_RING_SIZE];
+    static uint32_t _head[portNUM_PROCESSORS];
+};
+
+/**
+ * Marca o início e o fim de um trecho (ex: um handler HTTP).
+ *
+ * Os trechos de um núcleo só se encaixam se vierem de uma task fixada
+ * nele: o loop() no núcleo 1 e a task do HTTPS no núcleo 0 (HTTPS_CORE).
+ */
+class TraceSpan
+{
+public:
+    TraceSpan(TraceRoute route) : _route(route)
+    {
+        EventTracer::record(TRACE_HTTP_BEGIN, route);
+    }
+    ~TraceSpan()
+    {
+        EventTracer::record(TRACE_HTTP_END, _route);
+    }
+
+private:
+    TraceRoute _route;
+};
+
+#endif // EVENT_TRACER_H
@@ -0,0 +1,166 @@
+#include "DeltaEncoder.h"
+#include "DeltaPatch.h"
+#include <string.h>
+
+static const size_t SEED_SIZE = 8;     // Bytes do hash de busca
+static const size_t MIN_MATCH = 16;    // Trecho menor que isso vai como literal
+static const unsigned HASH_BITS = 20;  // 1 M entradas (4 MB)
+static const size_t MAX_STALL = 64;    // Para de estender sem melhora por 64 bytes
+static const uint32_t NO_POSITION = UINT32_MAX;
+
+static uint32_t hashSeed(const uint8_t *p)
+{
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return (uint32_t)((v * 0x9E3779B97F4A7C15ULL) >> (64 - HASH_BITS));
+}
+
+static void putVarint(std::vector<uint8_t> &out, uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        out.push_back((uint8_t)(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back((uint8_t)value);
+}
+
+static void putLE32(std::vector<uint8_t> &out, uint32_t value)
+{
+    for (int i = 0; i < 4; i++)
+        out.push_back((uint8_t)(value >> (8 * i)));
+}
+
+namespace
+{
+struct Encoder
+{
+    const uint8_t *src;
+    size_t srcSize;
+    const uint8_t *dst;
+    size_t dstSize;
+    std::vector<uint8_t> out;
+    uint32_t sourcePos = 0; // Espelho do _sourcePos do DeltaPatch
+
+    size_t exactLength(size_t s, size_t d) const
+    {
+        size_t n = 0;
+        while (s + n < srcSize && d + n < dstSize && src[s + n] == dst[d + n])
+            n++;
+        return n;
+    }
+
+    // Maior trecho com (iguais - diferentes) máximo; 'matches' recebe os iguais
+    size_t extend(size_t s, size_t d, size_t &matches) const
+    {
+        long score = 0;
+        long bestScore = 0;
+        size_t best = 0;
+        size_t equal = 0;
+        matches = 0;
+        for (size_t k = 0; s + k < srcSize && d + k < dstSize; k++)
+        {
+            bool same = src[s + k] == dst[d + k];
+            equal += same;
+            score += same ? 1 : -1;
+            if (score > bestScore)
+            {
+                bestScore = score;
+                best = k + 1;
+                matches = equal;
+            }
+            else if (k + 1 - best > MAX_STALL)
+            {
+                break;
+            }
+        }
+        return best;
+    }
+
+    void literal(size_t from, size_t to)
+    {
+        if (to <= from)
+            return;
+        out.push_back('L');
+        putVarint(out, to - from);
+        out.insert(out.end(), dst + from, dst + to);
+    }
+
+    void match(size_t s, size_t d, size_t len, size_t matches)
+    {
+        int64_t offset = (int64_t)s - (int64_t)sourcePos;
+        out.push_back(matches == len ? 'C' : 'A');
+        putVarint(out, ((uint64_t)offset << 1) ^ (uint64_t)(offset >> 63)); // zigzag
+        putVarint(out, len);
+        if (matches != len)
+        {
+            for (size_t k = 0; k < len; k++)
+                out.push_back((uint8_t)(dst[d + k] - src[s + k]));
+        }
+        sourcePos = (uint32_t)(s + len);
+    }
+};
+} // namespace
+
+std::vector<uint8_t> deltaEncode(const uint8_t *source, size_t sourceSize,
+                                 const uint8_t *target, size_t targetSize)
+{
+    Encoder e;
+    e.src = source;
+    e.srcSize = sourceSize;
+    e.dst = target;
+    e.dstSize = targetSize;
+
+    e.out.insert(e.out.end(), DELTA_MAGIC, DELTA_MAGIC + sizeof(DELTA_MAGIC));
+    putLE32(e.out, (uint32_t)targetSize);
+    putLE32(e.out, (uint32_t)sourceSize);
+    putLE32(e.out, deltaCrc32(0, source, sourceSize));
+
+    // Primeira ocorrência de cada hash na origem
+    std::vector<uint32_t> table((size_t)1 << HASH_BITS, NO_POSITION);
+    for (size_t i = 0; i + SEED_SIZE <= sourceSize; i++)
+    {
+        uint32_t &slot = table[hashSeed(source + i)];
+        if (slot == NO_POSITION)
+            slot = (uint32_t)i;
+    }
+
+    size_t i = 0;
+    size_t literalStart = 0;
+    int64_t lastShift = 0; // origem - destino do último trecho
+    while (i + SEED_SIZE <= targetSize)
+    {
+        size_t candidate = SIZE_MAX;
+
+        // 1. Trecho idêntico em qualquer lugar da origem
+        uint32_t hit = table[hashSeed(target + i)];
+        if (hit != NO_POSITION && e.exactLength(hit, i) >= MIN_MATCH)
+            candidate = hit;
+
+        // 2. Continuação do trecho anterior com alguns bytes trocados
+        //    (ex: endereços que mudaram depois de uma função crescer)
+        size_t matches = 0;
+        int64_t next = (int64_t)i + lastShift;
+        if (candidate == SIZE_MAX && next >= 0 && (size_t)next < sourceSize)
+        {
+            size_t len = e.extend((size_t)next, i, matches);
+            if (len >= MIN_MATCH && matches * 4 >= len * 3)
+                candidate = (size_t)next;
+        }
+
+        if (candidate == SIZE_MAX)
+        {
+            i++;
+            continue;
+        }
+
+        size_t len = e.extend(candidate, i, matches);
+        e.literal(literalStart, i);
+        e.match(candidate, i, len, matches);
+        lastShift = (int64_t)candidate - (int64_t)i;
+        i += len;
+        literalStart = i;
+    }
+    e.literal(literalStart, targetSize);
+    return e.out;
+}
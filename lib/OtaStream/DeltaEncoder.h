@@ -0,0 +1,19 @@
+#ifndef DELTA_ENCODER_H
+#define DELTA_ENCODER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+/**
+ * Gera o patch (formato em DeltaPatch.h) que transforma 'source' em 'target'.
+ *
+ * Roda no PC (tools/ota_delta e testes do env native): indexa a origem
+ * por hash de 8 bytes e estende cada trecho encontrado enquanto a maioria
+ * dos bytes coincide, como o bsdiff. Código que só mudou de endereço vira
+ * um comando 'A' com a diferença quase toda zero.
+ */
+std::vector<uint8_t> deltaEncode(const uint8_t *source, size_t sourceSize,
+                                 const uint8_t *target, size_t targetSize);
+
+#endif // DELTA_ENCODER_H
@@ -0,0 +1,240 @@
+#include "DeltaPatch.h"
+#include <string.h>
+
+// Tabela de 16 entradas (meio byte por vez): 64 bytes em vez de 1 KB
+static const uint32_t CRC_TABLE[16] = {
+    0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+    0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C};
+
+uint32_t deltaCrc32(uint32_t crc, const uint8_t *data, size_t len)
+{
+    crc = ~crc;
+    while (len--)
+    {
+        crc ^= *data++;
+        crc = (crc >> 4) ^ CRC_TABLE[crc & 0x0F];
+        crc = (crc >> 4) ^ CRC_TABLE[crc & 0x0F];
+    }
+    return ~crc;
+}
+
+static uint32_t readLE32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+DeltaPatch::DeltaPatch()
+{
+    begin(nullptr, nullptr, nullptr, nullptr);
+    _state = STATE_ERROR;
+}
+
+void DeltaPatch::begin(SourceReader reader, void *readerCtx, StreamSink sink, void *sinkCtx)
+{
+    _reader = reader;
+    _readerCtx = readerCtx;
+    _sink = sink;
+    _sinkCtx = sinkCtx;
+    _state = STATE_HEADER;
+    _headerLength = 0;
+    _targetSize = 0;
+    _sourceSize = 0;
+    _produced = 0;
+    _command = 0;
+    _varint = 0;
+    _varintShift = 0;
+    _offset = 0;
+    _length = 0;
+    _sourcePos = 0;
+    _error = nullptr;
+}
+
+bool DeltaPatch::write(const uint8_t *data, size_t len)
+{
+    if (_state == STATE_ERROR)
+        return false;
+
+    while (len > 0)
+    {
+        switch (_state)
+        {
+        case STATE_HEADER:
+        {
+            size_t n = DELTA_HEADER_SIZE - _headerLength;
+            if (n > len)
+                n = len;
+            memcpy(_header + _headerLength, data, n);
+            _headerLength += n;
+            data += n;
+            len -= n;
+            if (_headerLength == DELTA_HEADER_SIZE && !parseHeader())
+                return false;
+            break;
+        }
+
+        case STATE_COMMAND:
+            _command = *data++;
+            len--;
+            _varint = 0;
+            _varintShift = 0;
+            if (_command == 'C' || _command == 'A')
+                _state = STATE_OFFSET;
+            else if (_command == 'L')
+                _state = STATE_LENGTH;
+            else
+                return fail("Comando de patch invalido");
+            break;
+
+        case STATE_OFFSET:
+        case STATE_LENGTH:
+        {
+            uint8_t byte = *data++;
+            len--;
+            _varint |= (uint64_t)(byte & 0x7F) << _varintShift;
+            _varintShift += 7;
+            if (_varintShift > 35)
+                return fail("Patch invalido");
+            if (byte & 0x80)
+                break;
+
+            if (_state == STATE_OFFSET)
+            {
+                // zigzag: 0, -1, 1, -2, ... -> 0, 1, 2, 3, ...
+                _offset = (int64_t)(_varint >> 1) ^ -(int64_t)(_varint & 1);
+                _varint = 0;
+                _varintShift = 0;
+                _state = STATE_LENGTH;
+                break;
+            }
+            _length = (uint32_t)_varint;
+            if (!startCommand())
+                return false;
+            break;
+        }
+
+        case STATE_DATA:
+        {
+            size_t n = _length < len ? _length : len;
+            if (!applyData(data, n))
+                return false;
+            data += n;
+            len -= n;
+            _length -= n;
+            if (_length == 0)
+                _state = _produced == _targetSize ? STATE_DONE : STATE_COMMAND;
+            break;
+        }
+
+        case STATE_DONE:
+            return fail("Dados depois do fim do patch");
+
+        default:
+            return false;
+        }
+    }
+    return true;
+}
+
+// --- Funções Privadas ---
+
+bool DeltaPatch::parseHeader()
+{
+    if (memcmp(_header, DELTA_MAGIC, sizeof(DELTA_MAGIC)) != 0)
+        return fail("Patch invalido");
+
+    _targetSize = readLE32(_header + 4);
+    _sourceSize = readLE32(_header + 8);
+    uint32_t expected = readLE32(_header + 12);
+    if (_targetSize == 0)
+        return fail("Patch invalido");
+
+    // O patch só vale para a imagem exata de onde foi gerado
+    uint32_t crc = 0;
+    for (uint32_t pos = 0; pos < _sourceSize; pos += sizeof(_buffer))
+    {
+        size_t n = _sourceSize - pos < sizeof(_buffer) ? _sourceSize - pos : sizeof(_buffer);
+        if (!_reader(_readerCtx, pos, _buffer, n))
+            return fail("Falha ao ler a imagem de origem");
+        crc = deltaCrc32(crc, _buffer, n);
+    }
+    if (crc != expected)
+        return fail("O patch foi gerado para outra imagem de origem");
+
+    _state = STATE_COMMAND;
+    return true;
+}
+
+bool DeltaPatch::startCommand()
+{
+    if (_length == 0 || _length > _targetSize - _produced)
+        return fail("Patch invalido");
+
+    if (_command != 'L')
+    {
+        int64_t start = (int64_t)_sourcePos + _offset;
+        if (start < 0 || start + _length > _sourceSize)
+            return fail("Patch invalido");
+        _sourcePos = (uint32_t)start;
+    }
+
+    if (_command == 'C')
+    {
+        if (!copySource(_length))
+            return false;
+        _state = _produced == _targetSize ? STATE_DONE : STATE_COMMAND;
+        return true;
+    }
+    _state = STATE_DATA;
+    return true;
+}
+
+bool DeltaPatch::copySource(uint32_t len)
+{
+    while (len > 0)
+    {
+        size_t n = len < sizeof(_buffer) ? len : sizeof(_buffer);
+        if (!_reader(_readerCtx, _sourcePos, _buffer, n))
+            return fail("Falha ao ler a imagem de origem");
+        if (!emit(_buffer, n))
+            return false;
+        _sourcePos += n;
+        len -= n;
+    }
+    return true;
+}
+
+bool DeltaPatch::applyData(const uint8_t *data, size_t len)
+{
+    if (_command == 'L')
+        return emit(data, len);
+
+    while (len > 0)
+    {
+        size_t n = len < sizeof(_buffer) ? len : sizeof(_buffer);
+        if (!_reader(_readerCtx, _sourcePos, _buffer, n))
+            return fail("Falha ao ler a imagem de origem");
+        for (size_t i = 0; i < n; i++)
+            _buffer[i] += data[i];
+        if (!emit(_buffer, n))
+            return false;
+        _sourcePos += n;
+        data += n;
+        len -= n;
+    }
+    return true;
+}
+
+bool DeltaPatch::emit(const uint8_t *data, size_t len)
+{
+    if (!_sink(_sinkCtx, data, len))
+        return fail("Falha ao gravar a saida");
+    _produced += len;
+    return true;
+}
+
+bool DeltaPatch::fail(const char *error)
+{
+    _error = error;
+    _state = STATE_ERROR;
+    return false;
+}
@@ -0,0 +1,104 @@
+#ifndef DELTA_PATCH_H
+#define DELTA_PATCH_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "StreamInflate.h"
+
+// Lê 'len' bytes da imagem de origem a partir de 'offset'
+typedef bool (*SourceReader)(void *ctx, uint32_t offset, uint8_t *data, size_t len);
+
+// Formato do patch (inteiros little-endian):
+//
+//   0  4  "PDLT"
+//   4  4  tamanho da imagem nova
+//   8  4  tamanho da imagem de origem
+//  12  4  CRC-32 da imagem de origem
+//  16  ... comandos, até completar a imagem nova:
+//     'C' desloc len              copia 'len' bytes da origem
+//     'A' desloc len + len bytes  origem + byte do patch (módulo 256)
+//     'L' len + len bytes         bytes novos
+//
+// 'desloc' é zigzag-varint, relativo ao fim da cópia anterior na origem;
+// 'len' é varint. O 'A' cobre código que só mudou de endereço: a diferença
+// é quase toda zero e comprime bem no zlib.
+static const uint8_t DELTA_MAGIC[4] = {'P', 'D', 'L', 'T'};
+static const size_t DELTA_HEADER_SIZE = 16;
+
+/**
+ * CRC-32 (IEEE 802.3), o mesmo do zlib.
+ */
+uint32_t deltaCrc32(uint32_t crc, const uint8_t *data, size_t len);
+
+/**
+ * Aplica um patch em streaming sobre a imagem de origem.
+ *
+ * O patch chega em pedaços de qualquer tamanho; a imagem nova sai pelo
+ * sink em pedaços de até 256 bytes. A origem é lida pelo SourceReader
+ * (no ESP32, a partição que está rodando) e conferida pelo CRC-32 do
+ * cabeçalho antes do primeiro byte de saída.
+ *
+ * Só usa a biblioteca padrão: roda no ESP32 e nos testes do env native.
+ */
+class DeltaPatch
+{
+public:
+    DeltaPatch();
+
+    void begin(SourceReader reader, void *readerCtx, StreamSink sink, void *sinkCtx);
+
+    /**
+     * @brief Consome o próximo pedaço do patch.
+     * @return false em erro (patch inválido, origem errada, leitura ou sink falhou).
+     */
+    bool write(const uint8_t *data, size_t len);
+
+    bool finished() const { return _state == STATE_DONE; }
+    uint32_t targetSize() const { return _targetSize; }
+    uint32_t bytesOut() const { return _produced; }
+    const char *lastError() const { return _error; }
+
+private:
+    enum State
+    {
+        STATE_HEADER,
+        STATE_COMMAND,
+        STATE_OFFSET,
+        STATE_LENGTH,
+        STATE_DATA,
+        STATE_DONE,
+        STATE_ERROR,
+    };
+
+    bool parseHeader();
+    bool startCommand();
+    bool copySource(uint32_t len);
+    bool applyData(const uint8_t *data, size_t len);
+    bool emit(const uint8_t *data, size_t len);
+    bool fail(const char *error);
+
+    SourceReader _reader;
+    void *_readerCtx;
+    StreamSink _sink;
+    void *_sinkCtx;
+
+    State _state;
+    uint8_t _header[DELTA_HEADER_SIZE];
+    size_t _headerLength;
+    uint32_t _targetSize;
+    uint32_t _sourceSize;
+    uint32_t _produced;
+
+    // Comando em andamento
+    uint8_t _command;
+    uint64_t _varint;
+    unsigned _varintShift;
+    int64_t _offset;
+    uint32_t _length;
+    uint32_t _sourcePos; // Fim da última cópia na origem
+
+    uint8_t _buffer[256];
+    const char *_error;
+};
+
+#endif // DELTA_PATCH_H
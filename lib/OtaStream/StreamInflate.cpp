@@ -0,0 +1,539 @@
+#include "StreamInflate.h"
+#include <stdlib.h>
+#include <string.h>
+
+// --- Tabelas do deflate (RFC 1951, seção 3.2.5) ---
+static const uint16_t LENGTH_BASE[29] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+                                         35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+static const uint8_t LENGTH_EXTRA[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+                                         3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+static const uint16_t DIST_BASE[30] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129,
+                                       193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097,
+                                       6145, 8193, 12289, 16385, 24577};
+static const uint8_t DIST_EXTRA[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6,
+                                       6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+// Ordem em que chegam os tamanhos do código dos tamanhos
+static const uint8_t CODE_LENGTH_ORDER[19] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+
+static const uint32_t ADLER_MOD = 65521;
+// Maior bloco somado sem estourar 32 bits antes do módulo (o mesmo do zlib)
+static const size_t ADLER_NMAX = 5552;
+
+static uint32_t adler32(uint32_t adler, const uint8_t *data, size_t len)
+{
+    uint32_t a = adler & 0xFFFF;
+    uint32_t b = adler >> 16;
+    while (len > 0)
+    {
+        size_t n = len < ADLER_NMAX ? len : ADLER_NMAX;
+        len -= n;
+        while (n--)
+        {
+            a += *data++;
+            b += a;
+        }
+        a %= ADLER_MOD;
+        b %= ADLER_MOD;
+    }
+    return (b << 16) | a;
+}
+
+StreamInflate::StreamInflate()
+{
+    _sink = nullptr;
+    _ctx = nullptr;
+    _window = nullptr;
+    _error = nullptr;
+    _state = STATE_ERROR;
+}
+
+StreamInflate::~StreamInflate()
+{
+    end();
+}
+
+bool StreamInflate::begin(StreamSink sink, void *ctx)
+{
+    if (_window == nullptr)
+    {
+        _window = (uint8_t *)malloc(WINDOW_SIZE);
+        if (_window == nullptr)
+        {
+            _error = "Memoria insuficiente para descomprimir";
+            _state = STATE_ERROR;
+            return false;
+        }
+    }
+
+    _sink = sink;
+    _ctx = ctx;
+    _pos = 0;
+    _flushStart = 0;
+    _total = 0;
+    _sinkFailed = false;
+    _adler = 1;
+    _in = _inEnd = nullptr;
+    _bits = 0;
+    _bitCount = 0;
+    _state = STATE_HEADER;
+    _lastBlock = false;
+    _storedLeft = 0;
+    _error = nullptr;
+    return true;
+}
+
+bool StreamInflate::write(const uint8_t *data, size_t len)
+{
+    if (_state == STATE_DONE)
+        return true; // Ignora bytes depois do fim do fluxo (ex: padding)
+    if (_state == STATE_ERROR)
+        return false;
+
+    _in = data;
+    _inEnd = data + len;
+
+    while (_state != STATE_DONE)
+    {
+        fill();
+        Step result = step();
+        if (result == STEP_FAIL)
+            break;
+        if (result == STEP_NEED_INPUT && _in == _inEnd)
+            break;
+    }
+    _in = _inEnd = nullptr;
+
+    // Entrega o que já saiu, para o chamador ver o progresso a cada pedaço
+    if (_state != STATE_ERROR && !flush())
+    {
+        fail("Falha ao gravar a saida");
+    }
+    return _state != STATE_ERROR;
+}
+
+void StreamInflate::end()
+{
+    free(_window);
+    _window = nullptr;
+}
+
+// --- Funções Privadas ---
+
+StreamInflate::Step StreamInflate::step()
+{
+    switch (_state)
+    {
+    case STATE_HEADER:
+    {
+        unsigned used = 0;
+        uint32_t cmf, flg;
+        if (!take(8, used, cmf) || !take(8, used, flg))
+            return STEP_NEED_INPUT;
+        // Deflate, janela de até 32 KB, checksum do cabeçalho, sem dicionário
+        if ((cmf & 0x0F) != 8 || (cmf >> 4) > 7 || ((cmf << 8) | flg) % 31 != 0 || (flg & 0x20))
+            return fail("Cabecalho zlib invalido");
+        drop(used);
+        _state = STATE_BLOCK;
+        return STEP_OK;
+    }
+    case STATE_BLOCK:
+        return stepBlock();
+    case STATE_STORED_LENGTH:
+        return stepStoredLength();
+    case STATE_STORED_COPY:
+        return stepStoredCopy();
+    case STATE_TABLE_COUNTS:
+        return stepTableCounts();
+    case STATE_TABLE_CODE_LENGTHS:
+        return stepTableCodeLengths();
+    case STATE_TABLE_LENGTHS:
+        return stepTableLengths();
+    case STATE_CODES:
+        return stepCodes();
+    case STATE_TRAILER:
+        return stepTrailer();
+    case STATE_DONE:
+        return STEP_OK;
+    default:
+        return STEP_FAIL;
+    }
+}
+
+StreamInflate::Step StreamInflate::stepBlock()
+{
+    unsigned used = 0;
+    uint32_t header;
+    if (!take(3, used, header))
+        return STEP_NEED_INPUT;
+    drop(used);
+
+    _lastBlock = header & 1;
+    switch (header >> 1)
+    {
+    case 0: // Sem compressão: começa no próximo byte
+        drop(_bitCount & 7);
+        _state = STATE_STORED_LENGTH;
+        return STEP_OK;
+
+    case 1: // Códigos fixos
+    {
+        uint8_t *lengths = _lengths;
+        memset(lengths, 8, 144);
+        memset(lengths + 144, 9, 112);
+        memset(lengths + 256, 7, 24);
+        memset(lengths + 280, 8, 8);
+        build(_lencode, lengths, 288);
+        memset(lengths, 5, 30);
+        build(_distcode, lengths, 30);
+        _state = STATE_CODES;
+        return STEP_OK;
+    }
+
+    case 2: // Códigos dinâmicos: as tabelas vêm a seguir
+        _state = STATE_TABLE_COUNTS;
+        return STEP_OK;
+
+    default:
+        return fail("Tipo de bloco invalido");
+    }
+}
+
+StreamInflate::Step StreamInflate::stepStoredLength()
+{
+    unsigned used = 0;
+    uint32_t length, inverse;
+    if (!take(16, used, length) || !take(16, used, inverse))
+        return STEP_NEED_INPUT;
+    if (length != (~inverse & 0xFFFF))
+        return fail("Tamanho de bloco invalido");
+    drop(used);
+
+    _storedLeft = length;
+    _state = STATE_STORED_COPY;
+    return STEP_OK;
+}
+
+StreamInflate::Step StreamInflate::stepStoredCopy()
+{
+    while (_storedLeft > 0)
+    {
+        // Primeiro os bytes que já estão no acumulador de bits, depois a entrada direto
+        if (_bitCount >= 8)
+        {
+            put((uint8_t)_bits);
+            drop(8);
+        }
+        else if (_in < _inEnd)
+        {
+            put(*_in++);
+        }
+        else
+        {
+            return STEP_NEED_INPUT;
+        }
+        _storedLeft--;
+    }
+    if (_sinkFailed)
+        return fail("Falha ao gravar a saida");
+
+    _state = _lastBlock ? STATE_TRAILER : STATE_BLOCK;
+    return STEP_OK;
+}
+
+StreamInflate::Step StreamInflate::stepTableCounts()
+{
+    unsigned used = 0;
+    uint32_t lit, dist, codeLengths;
+    if (!take(5, used, lit) || !take(5, used, dist) || !take(4, used, codeLengths))
+        return STEP_NEED_INPUT;
+    drop(used);
+
+    _litCount = lit + 257;
+    _distCount = dist + 1;
+    _codeLengthCount = codeLengths + 4;
+    if (_litCount > 286 || _distCount > 30)
+        return fail("Tabela de codigos invalida");
+
+    memset(_lengths, 0, sizeof(_lengths));
+    _index = 0;
+    _state = STATE_TABLE_CODE_LENGTHS;
+    return STEP_OK;
+}
+
+StreamInflate::Step StreamInflate::stepTableCodeLengths()
+{
+    while (_index < _codeLengthCount)
+    {
+        fill();
+        unsigned used = 0;
+        uint32_t length;
+        if (!take(3, used, length))
+            return STEP_NEED_INPUT;
+        drop(used);
+        _lengths[CODE_LENGTH_ORDER[_index++]] = (uint8_t)length;
+    }
+
+    // O código dos tamanhos usa _lencode até as tabelas do bloco ficarem prontas
+    if (!build(_lencode, _lengths, 19))
+        return fail("Tabela de codigos invalida");
+
+    _index = 0;
+    _state = STATE_TABLE_LENGTHS;
+    return STEP_OK;
+}
+
+StreamInflate::Step StreamInflate::stepTableLengths()
+{
+    unsigned total = _litCount + _distCount;
+    while (_index < total)
+    {
+        fill();
+        unsigned used = 0;
+        int symbol = decode(_lencode, used);
+        if (symbol == -1)
+            return STEP_NEED_INPUT;
+        if (symbol < 0)
+            return fail("Tabela de codigos invalida");
+
+        if (symbol < 16)
+        {
+            drop(used);
+            _lengths[_index++] = (uint8_t)symbol;
+            continue;
+        }
+
+        // 16: repete o anterior 3-6 vezes; 17: 3-10 zeros; 18: 11-138 zeros
+        uint32_t extra;
+        uint8_t value = 0;
+        unsigned repeat;
+        if (symbol == 16)
+        {
+            if (_index == 0)
+                return fail("Tabela de codigos invalida");
+            if (!take(2, used, extra))
+                return STEP_NEED_INPUT;
+            value = _lengths[_index - 1];
+            repeat = 3 + extra;
+        }
+        else if (symbol == 17)
+        {
+            if (!take(3, used, extra))
+                return STEP_NEED_INPUT;
+            repeat = 3 + extra;
+        }
+        else
+        {
+            if (!take(7, used, extra))
+                return STEP_NEED_INPUT;
+            repeat = 11 + extra;
+        }
+        if (_index + repeat > total)
+            return fail("Tabela de codigos invalida");
+        drop(used);
+        while (repeat--)
+            _lengths[_index++] = value;
+    }
+
+    // Sem o código de fim de bloco não há como terminar o bloco
+    if (_lengths[256] == 0 || !build(_lencode, _lengths, _litCount) ||
+        !build(_distcode, _lengths + _litCount, _distCount))
+    {
+        return fail("Tabela de codigos invalida");
+    }
+    _state = STATE_CODES;
+    return STEP_OK;
+}
+
+StreamInflate::Step StreamInflate::stepCodes()
+{
+    while (true)
+    {
+        if (_sinkFailed)
+            return fail("Falha ao gravar a saida");
+
+        // Um símbolo com os bits extras e a distância são consumidos juntos
+        // (no máximo 48 bits), ou nada é consumido até chegar mais entrada
+        fill();
+        unsigned used = 0;
+        int symbol = decode(_lencode, used);
+        if (symbol == -1)
+            return STEP_NEED_INPUT;
+        if (symbol < 0)
+            return fail("Codigo invalido");
+
+        if (symbol < 256)
+        {
+            drop(used);
+            put((uint8_t)symbol);
+            continue;
+        }
+        if (symbol == 256)
+        {
+            drop(used);
+            _state = _lastBlock ? STATE_TRAILER : STATE_BLOCK;
+            return STEP_OK;
+        }
+
+        symbol -= 257;
+        if (symbol >= 29)
+            return fail("Codigo invalido");
+        uint32_t extra;
+        if (!take(LENGTH_EXTRA[symbol], used, extra))
+            return STEP_NEED_INPUT;
+        unsigned length = LENGTH_BASE[symbol] + extra;
+
+        int distSymbol = decode(_distcode, used);
+        if (distSymbol == -1)
+            return STEP_NEED_INPUT;
+        if (distSymbol < 0 || distSymbol >= 30)
+            return fail("Codigo invalido");
+        if (!take(DIST_EXTRA[distSymbol], used, extra))
+            return STEP_NEED_INPUT;
+        size_t distance = DIST_BASE[distSymbol] + extra;
+        if (distance > _total)
+            return fail("Distancia invalida");
+        drop(used);
+
+        while (length--)
+        {
+            put(_window[(_pos - distance) & (WINDOW_SIZE - 1)]);
+        }
+    }
+}
+
+StreamInflate::Step StreamInflate::stepTrailer()
+{
+    // O Adler-32 cobre tudo o que saiu: entrega o resto da janela antes de conferir
+    if (!flush())
+        return fail("Falha ao gravar a saida");
+
+    drop(_bitCount & 7);
+    unsigned used = 0;
+    uint32_t value;
+    if (!take(32, used, value))
+        return STEP_NEED_INPUT;
+    drop(used);
+
+    // Big-endian no fluxo
+    uint32_t expected = ((value & 0xFF) << 24) | ((value & 0xFF00) << 8) |
+                        ((value >> 8) & 0xFF00) | (value >> 24);
+    if (expected != _adler)
+        return fail("Adler-32 nao confere");
+
+    _state = STATE_DONE;
+    return STEP_OK;
+}
+
+// Completa o acumulador com a entrada disponível (pelo menos 57 bits, se houver)
+void StreamInflate::fill()
+{
+    while (_bitCount <= 56 && _in < _inEnd)
+    {
+        _bits |= (uint64_t)*_in++ << _bitCount;
+        _bitCount += 8;
+    }
+}
+
+// Lê n bits a partir de 'used' sem consumir; false se ainda não chegaram
+bool StreamInflate::take(unsigned n, unsigned &used, uint32_t &value) const
+{
+    if (used + n > _bitCount)
+        return false;
+    value = (uint32_t)((_bits >> used) & ((1ULL << n) - 1));
+    used += n;
+    return true;
+}
+
+// Decodifica um símbolo a partir de 'used'. -1: faltam bits; -2: código inválido.
+int StreamInflate::decode(const Huffman &h, unsigned &used) const
+{
+    int code = 0;
+    int first = 0;
+    int index = 0;
+    for (unsigned len = 1; len <= 15; len++)
+    {
+        if (used + len > _bitCount)
+            return -1;
+        code |= (int)((_bits >> (used + len - 1)) & 1);
+        int count = h.count[len];
+        if (code - count < first)
+        {
+            used += len;
+            return h.symbol[index + (code - first)];
+        }
+        index += count;
+        first += count;
+        first <<= 1;
+        code <<= 1;
+    }
+    return -2;
+}
+
+void StreamInflate::drop(unsigned n)
+{
+    _bits >>= n;
+    _bitCount -= n;
+}
+
+// Monta o código canônico a partir dos tamanhos. false se for super-ocupado.
+bool StreamInflate::build(Huffman &h, const uint8_t *lengths, unsigned n)
+{
+    memset(h.count, 0, sizeof(h.count));
+    for (unsigned symbol = 0; symbol < n; symbol++)
+        h.count[lengths[symbol]]++;
+    if (h.count[0] == n)
+        return true; // Nenhum código (ex: bloco sem distâncias)
+
+    int left = 1;
+    for (unsigned len = 1; len <= 15; len++)
+    {
+        left <<= 1;
+        left -= h.count[len];
+        if (left < 0)
+            return false;
+    }
+
+    uint16_t offsets[16];
+    offsets[1] = 0;
+    for (unsigned len = 1; len < 15; len++)
+        offsets[len + 1] = offsets[len] + h.count[len];
+    for (unsigned symbol = 0; symbol < n; symbol++)
+    {
+        if (lengths[symbol] != 0)
+            h.symbol[offsets[lengths[symbol]]++] = (uint16_t)symbol;
+    }
+    return true;
+}
+
+void StreamInflate::put(uint8_t byte)
+{
+    _window[_pos++] = byte;
+    _total++;
+    if (_pos == WINDOW_SIZE)
+    {
+        // Janela cheia: entrega ao sink e volta ao início
+        if (!flush())
+            _sinkFailed = true;
+        _pos = 0;
+        _flushStart = 0;
+    }
+}
+
+bool StreamInflate::flush()
+{
+    if (_pos <= _flushStart)
+        return !_sinkFailed;
+
+    const uint8_t *data = _window + _flushStart;
+    size_t len = _pos - _flushStart;
+    _flushStart = _pos;
+    _adler = adler32(_adler, data, len);
+    return _sink(_ctx, data, len) && !_sinkFailed;
+}
+
+StreamInflate::Step StreamInflate::fail(const char *error)
+{
+    _error = error;
+    _state = STATE_ERROR;
+    return STEP_FAIL;
+}
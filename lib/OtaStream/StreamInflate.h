@@ -0,0 +1,134 @@
+#ifndef STREAM_INFLATE_H
+#define STREAM_INFLATE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Recebe cada pedaço de saída; retorna false para abortar
+typedef bool (*StreamSink)(void *ctx, const uint8_t *data, size_t len);
+
+/**
+ * Descompressor zlib (RFC 1950/1951) em streaming.
+ *
+ * A entrada chega em pedaços de qualquer tamanho (até 1 byte) e o estado
+ * é retomado entre as chamadas. A saída passa por uma janela circular de
+ * 32 KB e é entregue ao sink em pedaços; nada mais da imagem fica em RAM.
+ * O Adler-32 do fim do fluxo é conferido.
+ *
+ * Só usa a biblioteca padrão: roda no ESP32 e nos testes do env native.
+ */
+class StreamInflate
+{
+public:
+    static const size_t WINDOW_SIZE = 32768;
+
+    StreamInflate();
+    ~StreamInflate();
+
+    /**
+     * @brief Aloca a janela e prepara um novo fluxo.
+     * @return false se não há memória para a janela.
+     */
+    bool begin(StreamSink sink, void *ctx);
+
+    /**
+     * @brief Consome o próximo pedaço do fluxo comprimido.
+     * @return false em erro (fluxo inválido, Adler-32 errado ou sink falhou).
+     */
+    bool write(const uint8_t *data, size_t len);
+
+    /**
+     * @brief Libera a janela.
+     */
+    void end();
+
+    bool finished() const { return _state == STATE_DONE; }
+    size_t bytesOut() const { return _total; }
+    const char *lastError() const { return _error; }
+
+private:
+    enum State
+    {
+        STATE_HEADER,
+        STATE_BLOCK,
+        STATE_STORED_LENGTH,
+        STATE_STORED_COPY,
+        STATE_TABLE_COUNTS,
+        STATE_TABLE_CODE_LENGTHS,
+        STATE_TABLE_LENGTHS,
+        STATE_CODES,
+        STATE_TRAILER,
+        STATE_DONE,
+        STATE_ERROR,
+    };
+
+    // Resultado de um passo da máquina de estados
+    enum Step
+    {
+        STEP_OK,
+        STEP_NEED_INPUT,
+        STEP_FAIL,
+    };
+
+    // Código de Huffman canônico: quantos códigos por tamanho e os símbolos em ordem
+    struct Huffman
+    {
+        uint16_t count[16];
+        uint16_t symbol[288];
+    };
+
+    Step step();
+    Step stepBlock();
+    Step stepStoredLength();
+    Step stepStoredCopy();
+    Step stepTableCounts();
+    Step stepTableCodeLengths();
+    Step stepTableLengths();
+    Step stepCodes();
+    Step stepTrailer();
+
+    void fill();
+    bool take(unsigned n, unsigned &used, uint32_t &value) const;
+    int decode(const Huffman &h, unsigned &used) const;
+    void drop(unsigned n);
+    static bool build(Huffman &h, const uint8_t *lengths, unsigned n);
+
+    void put(uint8_t byte);
+    bool flush();
+    Step fail(const char *error);
+
+    StreamSink _sink;
+    void *_ctx;
+    uint8_t *_window;
+    size_t _pos;        // Próxima posição de escrita na janela
+    size_t _flushStart; // Início do trecho da janela ainda não entregue ao sink
+    size_t _total;
+    bool _sinkFailed;
+    uint32_t _adler;
+
+    // Entrada do write() em andamento
+    const uint8_t *_in;
+    const uint8_t *_inEnd;
+
+    // Bits ainda não consumidos, do menos significativo para o mais
+    uint64_t _bits;
+    unsigned _bitCount;
+
+    State _state;
+    bool _lastBlock;
+    uint32_t _storedLeft;
+
+    // Leitura das tabelas de um bloco dinâmico
+    unsigned _litCount;
+    unsigned _distCount;
+    unsigned _codeLengthCount;
+    unsigned _index;
+    uint8_t _lengths[288 + 32];
+
+    Huffman _lencode;
+    Huffman _distcode;
+
+    const char *_error;
+};
+
+#endif // STREAM_INFLATE_H
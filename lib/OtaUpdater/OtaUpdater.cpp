@@ -0,0 +1,205 @@
+#include "OtaUpdater.h"
+#include <esp_ota_ops.h>
+
+// Primeiro byte de uma imagem de aplicação do ESP32
+static const uint8_t ESP_IMAGE_MAGIC = 0xE9;
+// Primeiro byte de um fluxo zlib com janela de 32 KB (CMF = 0x78)
+static const uint8_t ZLIB_CMF = 0x78;
+
+OtaUpdater::OtaUpdater()
+{
+    _running = nullptr;
+    _active = false;
+    _started = false;
+    _imageStarted = false;
+    _compressed = false;
+    _delta = false;
+    _received = 0;
+    _written = 0;
+    _error = nullptr;
+}
+
+OtaUpdater::~OtaUpdater()
+{
+    release();
+}
+
+bool OtaUpdater::begin(const char *md5)
+{
+    abort();
+
+    _received = 0;
+    _written = 0;
+    _started = false;
+    _imageStarted = false;
+    _compressed = false;
+    _delta = false;
+    _error = nullptr;
+
+    // Sem hash não há como saber se a imagem chegou inteira e é a certa
+    if (md5 == nullptr || strlen(md5) != 32)
+    {
+        _error = "MD5 da imagem obrigatorio";
+        return false;
+    }
+
+    // Tamanho final desconhecido: a imagem pode chegar comprimida
+    if (!Update.begin(UPDATE_SIZE_UNKNOWN, U_FLASH))
+    {
+        return fail("Nao foi possivel abrir o slot OTA");
+    }
+    Update.setMD5(md5);
+
+    _active = true;
+    return true;
+}
+
+bool OtaUpdater::write(const uint8_t *data, size_t len)
+{
+    if (!_active)
+        return false;
+    if (len == 0)
+        return true;
+
+    _received += len;
+
+    // Detecta o formato pelo primeiro byte recebido
+    if (!_started)
+    {
+        _started = true;
+        if (data[0] == ZLIB_CMF)
+        {
+            _compressed = true;
+            if (!_inflate.begin(inflateSink, this))
+            {
+                return fail(_inflate.lastError());
+            }
+        }
+    }
+
+    if (_compressed)
+    {
+        if (!_inflate.write(data, len))
+        {
+            // O erro pode ter vindo de dentro (patch ou flash). A janela só
+            // é liberada aqui, depois que o inflate terminou de usá-la.
+            if (_error == nullptr)
+                fail(_inflate.lastError());
+            release();
+            return false;
+        }
+        return true;
+    }
+    return writeImage(data, len);
+}
+
+bool OtaUpdater::end()
+{
+    if (!_active)
+        return false;
+
+    if ((_compressed && !_inflate.finished()) || (_delta && !_patch.finished()))
+    {
+        fail(_delta ? "Patch incompleto" : "Fluxo zlib incompleto");
+        release();
+        return false;
+    }
+
+    // Update.end() confere o MD5 e a imagem antes de trocar o boot
+    bool ok = Update.end(true);
+    _active = false;
+    release();
+
+    if (!ok)
+    {
+        _error = Update.errorString();
+        return false;
+    }
+    return true;
+}
+
+void OtaUpdater::abort()
+{
+    if (_active)
+    {
+        Update.abort();
+        _active = false;
+    }
+    release();
+}
+
+// --- Funções Privadas ---
+
+// Imagem já descomprimida: binária direto para a flash, ou patch
+bool OtaUpdater::writeImage(const uint8_t *data, size_t len)
+{
+    if (!_imageStarted)
+    {
+        _imageStarted = true;
+        if (data[0] == DELTA_MAGIC[0])
+        {
+            _running = esp_ota_get_running_partition();
+            if (_running == nullptr)
+                return fail("Particao atual nao encontrada");
+            _delta = true;
+            _patch.begin(readRunning, this, patchSink, this);
+        }
+        else if (data[0] != ESP_IMAGE_MAGIC)
+        {
+            return fail("Formato de imagem desconhecido");
+        }
+    }
+
+    if (_delta)
+    {
+        if (!_patch.write(data, len))
+        {
+            return _error != nullptr ? false : fail(_patch.lastError());
+        }
+        return true;
+    }
+    return flashWrite(data, len);
+}
+
+bool OtaUpdater::flashWrite(const uint8_t *data, size_t len)
+{
+    if (Update.write((uint8_t *)data, len) != len)
+    {
+        return fail(Update.errorString());
+    }
+    _written += len;
+    return true;
+}
+
+bool OtaUpdater::inflateSink(void *ctx, const uint8_t *data, size_t len)
+{
+    return ((OtaUpdater *)ctx)->writeImage(data, len);
+}
+
+bool OtaUpdater::patchSink(void *ctx, const uint8_t *data, size_t len)
+{
+    return ((OtaUpdater *)ctx)->flashWrite(data, len);
+}
+
+bool OtaUpdater::readRunning(void *ctx, uint32_t offset, uint8_t *data, size_t len)
+{
+    OtaUpdater *self = (OtaUpdater *)ctx;
+    return esp_partition_read(self->_running, offset, data, len) == ESP_OK;
+}
+
+// Pode ser chamada de dentro do inflate (pelo sink): não libera a janela
+bool OtaUpdater::fail(const char *error)
+{
+    _error = error;
+    if (_active)
+    {
+        Update.abort();
+        _active = false;
+    }
+    return false;
+}
+
+void OtaUpdater::release()
+{
+    _inflate.end(); // Libera a janela de 32 KB
+}
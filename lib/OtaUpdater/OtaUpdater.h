@@ -0,0 +1,84 @@
+#ifndef OTA_UPDATER_H
+#define OTA_UPDATER_H
+
+#include <Arduino.h>
+#include <Update.h>
+#include <esp_partition.h>
+#include "StreamInflate.h"
+#include "DeltaPatch.h"
+
+/**
+ * Grava uma imagem de firmware no slot OTA inativo, em streaming.
+ *
+ * O formato é detectado pelo primeiro byte:
+ *  - 0xE9: imagem binária normal;
+ *  - 0x78: zlib, com uma imagem ou um patch dentro;
+ *  - 'P':  patch (DeltaPatch.h) contra o firmware que está rodando.
+ *
+ * Patches são gerados no PC por tools/ota_delta. A descompressão usa uma
+ * janela fixa de 32 KB e o patch lê a origem direto da partição atual:
+ * nada da imagem é guardado em RAM além disso.
+ */
+class OtaUpdater
+{
+public:
+    OtaUpdater();
+    ~OtaUpdater();
+
+    /**
+     * @brief Prepara o slot OTA inativo para receber uma imagem.
+     * @param md5 Hash MD5 (hex) da imagem final. Obrigatório: é conferido
+     *            antes de trocar a partição de boot.
+     * @return true se o slot foi aberto.
+     */
+    bool begin(const char *md5);
+
+    /**
+     * @brief Recebe o próximo pedaço da imagem (comprimida ou não).
+     * @return false em caso de erro; a atualização deve ser abortada.
+     */
+    bool write(const uint8_t *data, size_t len);
+
+    /**
+     * @brief Finaliza: verifica o hash e marca o novo slot para o boot.
+     * @return true se a nova imagem foi aceita.
+     */
+    bool end();
+
+    /**
+     * @brief Cancela a atualização e libera a memória.
+     */
+    void abort();
+
+    bool isCompressed() const { return _compressed; }
+    bool isDelta() const { return _delta; }
+    size_t bytesReceived() const { return _received; }
+    size_t bytesWritten() const { return _written; }
+    const char *lastError() const { return _error; }
+
+private:
+    bool writeImage(const uint8_t *data, size_t len);
+    bool flashWrite(const uint8_t *data, size_t len);
+    bool fail(const char *error);
+    void release();
+
+    // Ligações entre as etapas (zlib -> patch -> flash)
+    static bool inflateSink(void *ctx, const uint8_t *data, size_t len);
+    static bool patchSink(void *ctx, const uint8_t *data, size_t len);
+    static bool readRunning(void *ctx, uint32_t offset, uint8_t *data, size_t len);
+
+    StreamInflate _inflate;
+    DeltaPatch _patch;
+    const esp_partition_t *_running; // Origem do patch
+
+    bool _active;
+    bool _started;      // Já recebeu o primeiro byte (formato detectado)
+    bool _imageStarted; // Já sabe se a imagem (descomprimida) é binária ou patch
+    bool _compressed;
+    bool _delta;
+    size_t _received;
+    size_t _written;
+    const char *_error;
+};
+
+#endif // OTA_UPDATER_H
@@ -0,0 +1,46 @@
+#ifndef ARG_WEB_SERVER_H
+#define ARG_WEB_SERVER_H
+
+#include <Arduino.h>
+#include <WebServer.h>
+
+/**
+ * Referência (sem cópia) para o valor de um argumento da requisição.
+ * Aponta para a memória do WebServer e só vale até o fim do handler.
+ */
+struct ArgView
+{
+    const char *data;
+    size_t length;
+
+    bool valid() const { return data != nullptr; }
+    int toInt() const { return data != nullptr ? atoi(data) : 0; }
+};
+
+/**
+ * WebServer com acesso aos argumentos sem copiá-los.
+ * O WebServer::arg() original retorna um String novo a cada chamada.
+ */
+class ArgWebServer : public WebServer
+{
+public:
+    ArgWebServer(int port = 80) : WebServer(port) {}
+
+    /**
+     * @brief Procura um argumento (query string ou formulário) pelo nome.
+     * @return ArgView inválido (data == nullptr) se não existir.
+     */
+    ArgView argView(const char *name) const
+    {
+        for (int i = 0; i < _currentArgCount; i++)
+        {
+            if (_currentArgs[i].key == name)
+            {
+                return {_currentArgs[i].value.c_str(), _currentArgs[i].value.length()};
+            }
+        }
+        return {nullptr, 0};
+    }
+};
+
+#endif // ARG_WEB_SERVER_H
@@ -0,0 +1,80 @@
+#include "RequestArena.h"
+#include <string.h>
+
+RequestArena::RequestArena(uint8_t *buffer, size_t capacity)
+    : _buffer(buffer), _capacity(capacity), _used(0), _peak(0)
+{
+}
+
+void *RequestArena::allocate(size_t size)
+{
+    size_t total = sizeof(Header) + align(size);
+    if (total > _capacity - _used)
+        return nullptr;
+
+    Header *header = (Header *)(_buffer + _used);
+    header->size = size;
+    _used += total;
+    if (_used > _peak)
+        _peak = _used;
+    return header + 1;
+}
+
+void RequestArena::deallocate(void *ptr)
+{
+    if (ptr == nullptr)
+        return;
+
+    // Só o último bloco pode ser devolvido; os outros esperam o reset()
+    Header *header = (Header *)ptr - 1;
+    if (isLast(header))
+    {
+        _used = (uint8_t *)header - _buffer;
+    }
+}
+
+void *RequestArena::reallocate(void *ptr, size_t new_size)
+{
+    if (ptr == nullptr)
+        return allocate(new_size);
+
+    Header *header = (Header *)ptr - 1;
+
+    // Último bloco: cresce ou encolhe no lugar
+    if (isLast(header))
+    {
+        size_t start = (uint8_t *)header - _buffer;
+        size_t total = sizeof(Header) + align(new_size);
+        if (total > _capacity - start)
+            return nullptr;
+        header->size = new_size;
+        _used = start + total;
+        if (_used > _peak)
+            _peak = _used;
+        return ptr;
+    }
+
+    // Encolher um bloco do meio não libera nada
+    if (new_size <= header->size)
+    {
+        header->size = new_size;
+        return ptr;
+    }
+
+    void *moved = allocate(new_size);
+    if (moved != nullptr)
+    {
+        memcpy(moved, ptr, header->size);
+    }
+    return moved;
+}
+
+void RequestArena::reset()
+{
+    _used = 0;
+}
+
+bool RequestArena::isLast(const Header *header) const
+{
+    return (const uint8_t *)header + sizeof(Header) + align(header->size) == _buffer + _used;
+}
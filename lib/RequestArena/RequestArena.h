@@ -0,0 +1,62 @@
+#ifndef REQUEST_ARENA_H
+#define REQUEST_ARENA_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <ArduinoJson.h>
+
+/**
+ * Alocador "bump" para a duração de uma requisição HTTP.
+ *
+ * Todas as alocações saem de um buffer fixo e são liberadas de uma só vez
+ * com reset(), depois que a resposta foi enviada. Implementa a interface
+ * de alocador do ArduinoJson, então um JsonDocument pode usá-lo direto:
+ *
+ *     JsonDocument doc(&arena);
+ *
+ * Se o buffer acabar, allocate() retorna nullptr e o ArduinoJson marca o
+ * documento como overflowed(); o heap nunca é usado.
+ *
+ * Não depende do Arduino: o teste de resistência roda no env native.
+ */
+class RequestArena : public ArduinoJson::Allocator
+{
+public:
+    RequestArena(uint8_t *buffer, size_t capacity);
+
+    void *allocate(size_t size) override;
+    void deallocate(void *ptr) override;
+    void *reallocate(void *ptr, size_t new_size) override;
+
+    /**
+     * @brief Libera todas as alocações. Chamar só depois que nenhum
+     * objeto (ex: JsonDocument) aponta mais para o buffer.
+     */
+    void reset();
+
+    size_t used() const { return _used; }
+    size_t capacity() const { return _capacity; }
+
+    /**
+     * @brief Maior uso desde a criação: mostra a folga real do buffer.
+     */
+    size_t peak() const { return _peak; }
+
+private:
+    // Cada bloco é precedido pelo seu tamanho, para o reallocate()
+    struct Header
+    {
+        size_t size;
+        size_t padding; // Mantém o bloco alinhado em 8 bytes
+    };
+
+    static size_t align(size_t size) { return (size + 7) & ~(size_t)7; }
+    bool isLast(const Header *header) const;
+
+    uint8_t *_buffer;
+    size_t _capacity;
+    size_t _used;
+    size_t _peak;
+};
+
+#endif // REQUEST_ARENA_H
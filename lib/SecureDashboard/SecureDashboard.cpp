@@ -0,0 +1,360 @@
+#include "SecureDashboard.h"
+#include <Preferences.h>
+
+// Tempo máximo esperando o loop principal atender um pedido (ms). O loop()
+// pode ficar ~2,5 s parado reconectando ao MQTT (connect de 500 ms + 2 s
+// de socket timeout do PubSubClient); o limite fica com folga acima disso.
+static const TickType_t LOOP_TIMEOUT = pdMS_TO_TICKS(5000);
+
+// Pilha da task do servidor: o handshake TLS e o POST /update (mesmo valor
+// do esp_https_server)
+static const size_t HTTPS_STACK_SIZE = 10240;
+
+// Cabeçalho "Authorization: Basic ..." do POST /update
+static const size_t AUTHORIZATION_SIZE = 128;
+
+// Pedaço da imagem lido por vez no POST /update
+static const size_t UPDATE_CHUNK_SIZE = 1024;
+
+// Corpo do POST /settings: "ligar=HH%3AMM&desligar=HH%3AMM&luzMaxima=NNN"
+static const size_t SETTINGS_BODY_SIZE = 128;
+
+/**
+ * @brief Decodifica um valor urlencoded no próprio buffer ("%3A" -> ':', '+' -> ' ').
+ */
+static void urlDecode(char *text)
+{
+    char *out = text;
+    for (char *in = text; *in; in++)
+    {
+        if (*in == '%' && isxdigit((unsigned char)in[1]) && isxdigit((unsigned char)in[2]))
+        {
+            char hex[3] = {in[1], in[2], '\0'};
+            *out++ = (char)strtol(hex, nullptr, 16);
+            in += 2;
+        }
+        else
+        {
+            *out++ = *in == '+' ? ' ' : *in;
+        }
+    }
+    *out = '\0';
+}
+
+SecureDashboard::SecureDashboard(DashboardServer &dashboard, uint16_t port)
+    : _dashboard(dashboard), _port(port)
+{
+    _handle = nullptr;
+    _requests = nullptr;
+    _results = nullptr;
+    _seq = 0;
+    _restartPending = false;
+    _restartAt = 0;
+}
+
+bool SecureDashboard::begin()
+{
+    if (_handle != nullptr)
+        return true;
+
+    size_t certLength = 0;
+    size_t keyLength = 0;
+    uint8_t *cert = loadCredential("cert", certLength);
+    uint8_t *key = loadCredential("key", keyLength);
+    if (cert == nullptr || key == nullptr)
+    {
+        LOG_W("[HTTPS] Sem certificado no NVS (namespace \"tls\"). HTTPS desativado.\n");
+        free(cert);
+        free(key);
+        return false;
+    }
+
+    // O mbedTLS guarda a sua cópia decodificada: o PEM pode ser liberado
+    bool credentialsOk = _tls.begin(cert, certLength, key, keyLength);
+    free(cert);
+    free(key);
+    if (!credentialsOk)
+        return false;
+
+    _requests = xQueueCreate(1, sizeof(JobRequest));
+    _results = xQueueCreate(1, sizeof(JobResult));
+
+    httpd_config_t conf = HTTPD_DEFAULT_CONFIG();
+    conf.server_port = _port;
+    conf.stack_size = HTTPS_STACK_SIZE;
+    conf.core_id = HTTPS_CORE;
+    conf.max_open_sockets = HTTPS_MAX_SOCKETS;
+    conf.lru_purge_enable = true; // Conexão ociosa mais antiga cede a vaga
+    _tls.install(conf);
+
+    esp_err_t err = httpd_start(&_handle, &conf);
+    if (err != ESP_OK)
+    {
+        LOG_E("[HTTPS] Falha ao iniciar o servidor: %s\n", esp_err_to_name(err));
+        _handle = nullptr;
+        return false;
+    }
+
+    httpd_uri_t root = {"/", HTTP_GET, handleRoot, this};
+    httpd_uri_t data = {"/data.json", HTTP_GET, handleDataJson, this};
+    httpd_uri_t settings = {"/settings", HTTP_POST, handleSettings, this};
+    httpd_register_uri_handler(_handle, &root);
+    httpd_register_uri_handler(_handle, &data);
+    httpd_register_uri_handler(_handle, &settings);
+    if constexpr (ActiveBoard::has(FEATURE_OTA))
+    {
+        httpd_uri_t update = {"/update", HTTP_POST, handleUpdate, this};
+        httpd_register_uri_handler(_handle, &update);
+    }
+
+    LOG_I("[HTTPS] Servidor iniciado na porta %u (retomada de sessao: %s).\n", _port, TlsTransport::resumptionModes());
+    return true;
+}
+
+void SecureDashboard::loop()
+{
+    if (_restartPending && millis() - _restartAt >= 1000)
+    {
+        AsyncLog::flush();
+        ESP.restart();
+    }
+
+    JobRequest request;
+    if (_requests == nullptr || xQueueReceive(_requests, &request, 0) != pdTRUE)
+        return;
+
+    JobResult result = {request.seq, false, 0};
+    if (request.job == JOB_DATA)
+    {
+        result.length = _dashboard.renderData(_json, sizeof(_json));
+        result.ok = result.length > 0;
+    }
+    else
+    {
+        result.ok = _dashboard.applySettings(request.ligar, request.desligar, request.luzMaxima);
+    }
+
+    // Sobrescreve uma resposta antiga que ninguém leu
+    xQueueOverwrite(_results, &result);
+}
+
+// --- Handlers (task do servidor HTTPS) ---
+
+esp_err_t SecureDashboard::handleRoot(httpd_req_t *req)
+{
+    TraceSpan span(TRACE_ROUTE_ROOT);
+    httpd_resp_set_type(req, "text/html");
+    return httpd_resp_send(req, DashboardServer::dashboardHtml(), HTTPD_RESP_USE_STRLEN);
+}
+
+esp_err_t SecureDashboard::handleDataJson(httpd_req_t *req)
+{
+    TraceSpan span(TRACE_ROUTE_DATA);
+    SecureDashboard *self = (SecureDashboard *)req->user_ctx;
+
+    JobRequest request = {};
+    request.job = JOB_DATA;
+    JobResult result;
+    if (!self->runOnLoop(request, result))
+    {
+        return sendBusy(req);
+    }
+    if (!result.ok)
+    {
+        return httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "Resposta muito grande");
+    }
+    httpd_resp_set_type(req, "application/json");
+    return httpd_resp_send(req, self->_json, result.length);
+}
+
+esp_err_t SecureDashboard::handleSettings(httpd_req_t *req)
+{
+    TraceSpan span(TRACE_ROUTE_SETTINGS);
+    SecureDashboard *self = (SecureDashboard *)req->user_ctx;
+
+    char body[SETTINGS_BODY_SIZE];
+    if (req->content_len >= sizeof(body))
+    {
+        return httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Bad Request");
+    }
+
+    size_t received = 0;
+    while (received < req->content_len)
+    {
+        int n = httpd_req_recv(req, body + received, req->content_len - received);
+        if (n == HTTPD_SOCK_ERR_TIMEOUT)
+            continue;
+        if (n <= 0)
+            return ESP_FAIL;
+        received += n;
+    }
+    body[received] = '\0';
+
+    char ligar[16];
+    char desligar[16];
+    char luzMaxima[8];
+    if (httpd_query_key_value(body, "ligar", ligar, sizeof(ligar)) != ESP_OK ||
+        httpd_query_key_value(body, "desligar", desligar, sizeof(desligar)) != ESP_OK ||
+        httpd_query_key_value(body, "luzMaxima", luzMaxima, sizeof(luzMaxima)) != ESP_OK)
+    {
+        return httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Bad Request");
+    }
+    urlDecode(ligar);
+    urlDecode(desligar);
+
+    JobRequest request = {};
+    request.job = JOB_SETTINGS;
+    strlcpy(request.ligar, ligar, sizeof(request.ligar));
+    strlcpy(request.desligar, desligar, sizeof(request.desligar));
+    request.luzMaxima = atoi(luzMaxima);
+
+    JobResult result;
+    if (!self->runOnLoop(request, result))
+    {
+        return sendBusy(req);
+    }
+    if (!result.ok)
+    {
+        return httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Bad Request");
+    }
+    httpd_resp_set_type(req, "text/plain");
+    return httpd_resp_send(req, "OK", HTTPD_RESP_USE_STRLEN);
+}
+
+// POST /update?md5=...: a imagem crua no corpo, gravada em streaming
+esp_err_t SecureDashboard::handleUpdate(httpd_req_t *req)
+{
+    TraceSpan span(TRACE_ROUTE_UPDATE);
+    SecureDashboard *self = (SecureDashboard *)req->user_ctx;
+
+    // Sem WWW-Authenticate: a página manda a senha, o navegador não deve abrir o diálogo
+    if (!self->_dashboard.otaEnabled())
+    {
+        return httpd_resp_send_err(req, HTTPD_403_FORBIDDEN, "OTA desativado: defina a senha de administrador no portal");
+    }
+    char authorization[AUTHORIZATION_SIZE];
+    if (httpd_req_get_hdr_value_str(req, "Authorization", authorization, sizeof(authorization)) != ESP_OK ||
+        !self->_dashboard.checkAdminAuthorization(authorization))
+    {
+        LOG_W("[OTA] Upload recusado: senha de administrador ausente ou invalida.\n");
+        httpd_resp_set_status(req, "401 Unauthorized");
+        httpd_resp_set_type(req, "text/plain");
+        return httpd_resp_send(req, "Senha de administrador invalida", HTTPD_RESP_USE_STRLEN);
+    }
+
+    // O MD5 (obrigatório) vem na query string (?md5=...)
+    char query[64];
+    char md5[33] = "";
+    if (httpd_req_get_url_query_str(req, query, sizeof(query)) == ESP_OK)
+    {
+        httpd_query_key_value(query, "md5", md5, sizeof(md5));
+    }
+
+    OtaUpdater &ota = self->_ota;
+    LOG_I("[OTA] Recebendo %u bytes por HTTPS...\n", (unsigned)req->content_len);
+    bool ok = ota.begin(md5);
+
+    uint8_t chunk[UPDATE_CHUNK_SIZE];
+    size_t received = 0;
+    while (ok && received < req->content_len)
+    {
+        size_t wanted = req->content_len - received;
+        int n = httpd_req_recv(req, (char *)chunk, wanted < sizeof(chunk) ? wanted : sizeof(chunk));
+        if (n == HTTPD_SOCK_ERR_TIMEOUT)
+            continue;
+        if (n <= 0)
+        {
+            ota.abort();
+            LOG_W("[OTA] Upload interrompido.\n");
+            return ESP_FAIL;
+        }
+        received += n;
+        ok = ota.write(chunk, n);
+    }
+
+    if (ok)
+    {
+        ok = ota.end();
+        LOG_I("[OTA] %u bytes recebidos, %u gravados (%s).\n",
+              (unsigned)ota.bytesReceived(), (unsigned)ota.bytesWritten(),
+              ota.isDelta() ? "patch" : ota.isCompressed() ? "zlib" : "binario");
+    }
+    if (!ok)
+    {
+        // O resto do corpo não é lido: o servidor fecha a conexão
+        const char *error = ota.lastError();
+        LOG_W("[OTA] Falha: %s\n", error);
+        ota.abort();
+        return httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, error != nullptr ? error : "Falha na atualizacao");
+    }
+
+    httpd_resp_set_type(req, "text/plain");
+    httpd_resp_send(req, "OK. Reiniciando...", HTTPD_RESP_USE_STRLEN);
+    LOG_I("[OTA] Nova imagem aceita. Reiniciando em 1 segundo...\n");
+
+    // O reinício fica para o loop(), depois que a resposta saiu
+    self->_restartAt = millis();
+    self->_restartPending = true;
+    return ESP_OK;
+}
+
+// --- Funções Privadas ---
+
+// Entrega o pedido ao loop() e espera a resposta com o mesmo número de
+// sequência. Só a task do servidor (uma só) chama: há no máximo um
+// pedido na fila, e uma resposta de um pedido que expirou é descartada.
+// Retorna false se o loop() não respondeu a tempo; o resultado do pedido
+// fica em result.ok.
+bool SecureDashboard::runOnLoop(JobRequest &request, JobResult &result)
+{
+    request.seq = ++_seq;
+    xQueueOverwrite(_requests, &request);
+
+    TickType_t start = xTaskGetTickCount();
+    TickType_t elapsed = 0;
+    while (elapsed < LOOP_TIMEOUT)
+    {
+        if (xQueueReceive(_results, &result, LOOP_TIMEOUT - elapsed) == pdTRUE && result.seq == request.seq)
+            return true;
+        elapsed = xTaskGetTickCount() - start;
+    }
+
+    // Retira o pedido se o loop() ainda não o pegou; se já pegou, a
+    // resposta chega depois e é descartada pelo número de sequência
+    JobRequest pending;
+    xQueueReceive(_requests, &pending, 0);
+    LOG_W("[HTTPS] O loop principal nao respondeu a tempo.\n");
+    return false;
+}
+
+// O loop() não atendeu a tempo: o pedido não foi feito, o cliente tenta de novo
+esp_err_t SecureDashboard::sendBusy(httpd_req_t *req)
+{
+    httpd_resp_set_status(req, "503 Service Unavailable");
+    httpd_resp_set_hdr(req, "Retry-After", "1");
+    httpd_resp_set_type(req, "text/plain");
+    return httpd_resp_send(req, "Ocupado, tente de novo", HTTPD_RESP_USE_STRLEN);
+}
+
+// Lê um PEM do NVS e termina com '\0' (o mbedTLS exige o terminador)
+uint8_t *SecureDashboard::loadCredential(const char *key, size_t &length)
+{
+    Preferences preferences;
+    if (!preferences.begin("tls", true))
+        return nullptr;
+
+    uint8_t *buffer = nullptr;
+    size_t size = preferences.getBytesLength(key);
+    if (size > 0)
+    {
+        buffer = (uint8_t *)malloc(size + 1);
+        if (buffer != nullptr)
+        {
+            preferences.getBytes(key, buffer, size);
+            buffer[size] = '\0';
+            length = size + 1;
+        }
+    }
+    preferences.end();
+    return buffer;
+}
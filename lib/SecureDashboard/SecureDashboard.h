@@ -0,0 +1,113 @@
+#ifndef SECURE_DASHBOARD_H
+#define SECURE_DASHBOARD_H
+
+#include <Arduino.h>
+#include <freertos/queue.h>
+#include "DashboardServer.h"
+#include "OtaUpdater.h"
+#include "TlsTransport.h"
+
+// Conexões TLS abertas ao mesmo tempo (cada uma usa ~40 KB de heap no mbedTLS)
+#ifndef HTTPS_MAX_SOCKETS
+#define HTTPS_MAX_SOCKETS 3
+#endif
+
+// Núcleo da task do servidor. O loop() do Arduino roda no núcleo 1, então
+// os TraceSpan dos handlers ficam sozinhos no buffer do núcleo 0 (EventTracer).
+#ifndef HTTPS_CORE
+#define HTTPS_CORE 0
+#endif
+
+/**
+ * Dashboard por HTTPS (esp_http_server com TlsTransport), ao lado do HTTP da porta 80.
+ * Com o HTTPS no ar, a porta 80 só redireciona a página e não aceita
+ * /settings nem /update (DashboardServer::redirectToHttps).
+ *
+ * O certificado e a chave (PEM) ficam no NVS, namespace "tls", chaves
+ * "cert" e "key" (blobs). Sem eles o HTTPS não sobe. Para gravar na
+ * fábrica, uma linha no CSV do nvs_partition_gen.py:
+ *
+ *     tls,namespace,,
+ *     cert,file,binary,servidor.crt
+ *     key,file,binary,servidor.key
+ *
+ * O custo do TLS fica no handshake; por isso as conexões são mantidas
+ * abertas (keep-alive do esp_http_server) e as conexões novas retomam a
+ * sessão anterior do navegador (TlsTransport, também no IDF 4.4). AES,
+ * SHA e RSA/ECC usam os aceleradores do ESP32 (ligados no sdkconfig
+ * padrão do Arduino).
+ *
+ * O servidor roda numa task própria, fixada no núcleo HTTPS_CORE. As
+ * rotas que tocam no estado do sketch (/data.json e /settings) são
+ * executadas no loop principal, em loop(), pelo mesmo código do
+ * DashboardServer. O POST /update grava a imagem direto da task do
+ * servidor.
+ */
+class SecureDashboard
+{
+public:
+    SecureDashboard(DashboardServer &dashboard, uint16_t port = 443);
+
+    /**
+     * @brief Lê as credenciais do NVS e inicia o servidor.
+     * @return false se não há certificado ou o servidor não subiu.
+     */
+    bool begin();
+
+    /**
+     * @brief Atende os pedidos pendentes. Chamar em cada loop() do sketch principal.
+     */
+    void loop();
+
+private:
+    enum Job
+    {
+        JOB_DATA,
+        JOB_SETTINGS,
+    };
+
+    // Pedido da task do servidor ao loop(), copiado pela fila
+    struct JobRequest
+    {
+        uint32_t seq;
+        Job job;
+        char ligar[6];
+        char desligar[6];
+        int luzMaxima;
+    };
+
+    // Resposta do loop(); seq diz a que pedido ela pertence
+    struct JobResult
+    {
+        uint32_t seq;
+        bool ok;
+        size_t length; // Bytes do JSON em _json (JOB_DATA)
+    };
+
+    static esp_err_t handleRoot(httpd_req_t *req);
+    static esp_err_t handleDataJson(httpd_req_t *req);
+    static esp_err_t handleSettings(httpd_req_t *req);
+    static esp_err_t handleUpdate(httpd_req_t *req);
+
+    bool runOnLoop(JobRequest &request, JobResult &result);
+    static esp_err_t sendBusy(httpd_req_t *req);
+    static uint8_t *loadCredential(const char *key, size_t &length);
+
+    DashboardServer &_dashboard;
+    uint16_t _port;
+    httpd_handle_t _handle;
+    TlsTransport _tls;
+
+    // --- Troca com o loop principal (filas de 1 posição) ---
+    QueueHandle_t _requests;
+    QueueHandle_t _results;
+    uint32_t _seq; // Só a task do servidor incrementa
+    char _json[DashboardServer::JSON_RESPONSE_SIZE]; // Escrito pelo loop() antes do resultado
+
+    // --- Atualização OTA (/update) ---
+    OtaUpdater _ota;
+    volatile bool _restartPending; // Imagem aceita: o loop() reinicia
+    unsigned long _restartAt;
+};
+
+#endif // SECURE_DASHBOARD_H
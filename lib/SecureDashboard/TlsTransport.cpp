@@ -0,0 +1,241 @@
+#include "TlsTransport.h"
+#include "AsyncLog.h"
+#include <unistd.h> // close()
+
+// Personalização do gerador aleatório (mbedtls_ctr_drbg_seed)
+static const char DRBG_PERSONALIZATION[] = "SecureDashboard";
+
+TlsTransport::TlsTransport()
+{
+    _resuming = false;
+    _fullHandshakes = 0;
+    _resumedHandshakes = 0;
+}
+
+bool TlsTransport::begin(const uint8_t *cert, size_t certLength, const uint8_t *key, size_t keyLength)
+{
+    mbedtls_entropy_init(&_entropy);
+    mbedtls_ctr_drbg_init(&_drbg);
+    mbedtls_x509_crt_init(&_cert);
+    mbedtls_pk_init(&_key);
+    mbedtls_ssl_config_init(&_config);
+
+    int ret = mbedtls_ctr_drbg_seed(&_drbg, mbedtls_entropy_func, &_entropy,
+                                    (const unsigned char *)DRBG_PERSONALIZATION, sizeof(DRBG_PERSONALIZATION) - 1);
+    if (ret == 0)
+        ret = mbedtls_x509_crt_parse(&_cert, cert, certLength);
+    if (ret == 0)
+    {
+#if MBEDTLS_VERSION_NUMBER >= 0x03000000
+        ret = mbedtls_pk_parse_key(&_key, key, keyLength, nullptr, 0, mbedtls_ctr_drbg_random, &_drbg);
+#else
+        ret = mbedtls_pk_parse_key(&_key, key, keyLength, nullptr, 0);
+#endif
+    }
+    if (ret == 0)
+        ret = mbedtls_ssl_config_defaults(&_config, MBEDTLS_SSL_IS_SERVER, MBEDTLS_SSL_TRANSPORT_STREAM,
+                                          MBEDTLS_SSL_PRESET_DEFAULT);
+    if (ret == 0)
+        ret = mbedtls_ssl_conf_own_cert(&_config, &_cert, &_key);
+    if (ret != 0)
+    {
+        LOG_E("[HTTPS] Certificado ou chave invalidos (mbedTLS -0x%04x).\n", (unsigned)-ret);
+        return false;
+    }
+    mbedtls_ssl_conf_rng(&_config, mbedtls_ctr_drbg_random, &_drbg);
+
+#if defined(MBEDTLS_SSL_CACHE_C)
+    // Retomada por ID: o servidor guarda as últimas sessões
+    mbedtls_ssl_cache_init(&_cache);
+    mbedtls_ssl_cache_set_max_entries(&_cache, TLS_SESSION_CACHE_SIZE);
+    mbedtls_ssl_cache_set_timeout(&_cache, TLS_SESSION_LIFETIME);
+    mbedtls_ssl_conf_session_cache(&_config, this, cacheGet, cacheSet);
+#endif
+#ifdef TLS_SESSION_TICKETS
+    // Retomada por ticket: a sessão volta cifrada pelo cliente, sem ocupar o cache
+    mbedtls_ssl_ticket_init(&_ticket);
+    if (mbedtls_ssl_ticket_setup(&_ticket, mbedtls_ctr_drbg_random, &_drbg, MBEDTLS_CIPHER_AES_256_GCM,
+                                 TLS_SESSION_LIFETIME) == 0)
+    {
+        mbedtls_ssl_conf_session_tickets_cb(&_config, ticketWrite, ticketParse, this);
+    }
+#endif
+    return true;
+}
+
+void TlsTransport::install(httpd_config_t &config)
+{
+    config.global_transport_ctx = this;
+    config.global_transport_ctx_free_fn = nullptr; // Vive tanto quanto o SecureDashboard
+    config.open_fn = openConnection;
+    config.close_fn = closeConnection;
+}
+
+const char *TlsTransport::resumptionModes()
+{
+#if defined(MBEDTLS_SSL_CACHE_C) && defined(TLS_SESSION_TICKETS)
+    return "cache de sessoes e tickets";
+#elif defined(MBEDTLS_SSL_CACHE_C)
+    return "cache de sessoes";
+#elif defined(TLS_SESSION_TICKETS)
+    return "tickets";
+#else
+    return "nenhuma (sem MBEDTLS_SSL_CACHE_C nem MBEDTLS_SSL_TICKET_C)";
+#endif
+}
+
+// --- Callbacks do esp_http_server (task do servidor) ---
+
+// Conexão aceita: faz o handshake antes de o httpd ler o pedido
+esp_err_t TlsTransport::openConnection(httpd_handle_t hd, int sockfd)
+{
+    TlsTransport *self = (TlsTransport *)httpd_get_global_transport_ctx(hd);
+    Connection *connection = (Connection *)calloc(1, sizeof(Connection));
+    if (connection == nullptr)
+        return ESP_ERR_NO_MEM;
+
+    mbedtls_ssl_init(&connection->ssl);
+    connection->net.fd = sockfd;
+    if (mbedtls_ssl_setup(&connection->ssl, &self->_config) != 0)
+    {
+        freeConnection(connection);
+        return ESP_FAIL;
+    }
+    mbedtls_ssl_set_bio(&connection->ssl, &connection->net, mbedtls_net_send, mbedtls_net_recv, nullptr);
+
+    unsigned long start = millis();
+    self->_resuming = false;
+    int ret = self->handshake(*connection);
+    if (ret != 0)
+    {
+        // Comum com certificado autoassinado: o navegador desiste e reconecta
+        LOG_D("[HTTPS] Handshake falhou (mbedTLS -0x%04x).\n", (unsigned)-ret);
+        freeConnection(connection);
+        return ESP_FAIL;
+    }
+    if (self->_resuming)
+        self->_resumedHandshakes++;
+    else
+        self->_fullHandshakes++;
+    LOG_D("[HTTPS] Handshake %s em %lu ms.\n", self->_resuming ? "retomado" : "completo", millis() - start);
+
+    httpd_sess_set_transport_ctx(hd, sockfd, connection, freeConnection);
+    httpd_sess_set_send_override(hd, sockfd, tlsSend);
+    httpd_sess_set_recv_override(hd, sockfd, tlsRecv);
+    httpd_sess_set_pending_override(hd, sockfd, tlsPending);
+    return ESP_OK;
+}
+
+// Com close_fn definido, fechar o socket fica por conta dela. Também é
+// chamada quando o openConnection() falhou (sem transport_ctx).
+void TlsTransport::closeConnection(httpd_handle_t hd, int sockfd)
+{
+    Connection *connection = (Connection *)httpd_sess_get_transport_ctx(hd, sockfd);
+    if (connection != nullptr)
+        mbedtls_ssl_close_notify(&connection->ssl);
+    close(sockfd);
+}
+
+void TlsTransport::freeConnection(void *ctx)
+{
+    Connection *connection = (Connection *)ctx;
+    mbedtls_ssl_free(&connection->ssl);
+    free(connection);
+}
+
+int TlsTransport::tlsSend(httpd_handle_t hd, int sockfd, const char *buf, size_t len, int flags)
+{
+    Connection *connection = (Connection *)httpd_sess_get_transport_ctx(hd, sockfd);
+    return toSocketResult(mbedtls_ssl_write(&connection->ssl, (const unsigned char *)buf, len));
+}
+
+int TlsTransport::tlsRecv(httpd_handle_t hd, int sockfd, char *buf, size_t len, int flags)
+{
+    Connection *connection = (Connection *)httpd_sess_get_transport_ctx(hd, sockfd);
+    return toSocketResult(mbedtls_ssl_read(&connection->ssl, (unsigned char *)buf, len));
+}
+
+// Bytes já decifrados esperando leitura (o select() do httpd não os vê)
+int TlsTransport::tlsPending(httpd_handle_t hd, int sockfd)
+{
+    Connection *connection = (Connection *)httpd_sess_get_transport_ctx(hd, sockfd);
+    return (int)mbedtls_ssl_get_bytes_avail(&connection->ssl);
+}
+
+// Retorno do mbedTLS no formato que o httpd espera de send()/recv()
+int TlsTransport::toSocketResult(int ret)
+{
+    if (ret >= 0)
+        return ret;
+    if (ret == MBEDTLS_ERR_SSL_WANT_READ || ret == MBEDTLS_ERR_SSL_WANT_WRITE)
+        return HTTPD_SOCK_ERR_TIMEOUT;
+    if (ret == MBEDTLS_ERR_SSL_PEER_CLOSE_NOTIFY)
+        return 0; // Fim da conexão, como um recv() de 0 bytes
+    return HTTPD_SOCK_ERR_FAIL;
+}
+
+// --- Retomada de sessão ---
+
+#if defined(MBEDTLS_SSL_CACHE_C)
+#if MBEDTLS_VERSION_NUMBER >= 0x03000000
+int TlsTransport::cacheGet(void *ctx, const unsigned char *id, size_t idLength, mbedtls_ssl_session *session)
+{
+    TlsTransport *self = (TlsTransport *)ctx;
+    int ret = mbedtls_ssl_cache_get(&self->_cache, id, idLength, session);
+    self->_resuming |= ret == 0;
+    return ret;
+}
+
+int TlsTransport::cacheSet(void *ctx, const unsigned char *id, size_t idLength, const mbedtls_ssl_session *session)
+{
+    return mbedtls_ssl_cache_set(&((TlsTransport *)ctx)->_cache, id, idLength, session);
+}
+#else
+int TlsTransport::cacheGet(void *ctx, mbedtls_ssl_session *session)
+{
+    TlsTransport *self = (TlsTransport *)ctx;
+    int ret = mbedtls_ssl_cache_get(&self->_cache, session);
+    self->_resuming |= ret == 0;
+    return ret;
+}
+
+int TlsTransport::cacheSet(void *ctx, const mbedtls_ssl_session *session)
+{
+    return mbedtls_ssl_cache_set(&((TlsTransport *)ctx)->_cache, session);
+}
+#endif
+#endif
+
+#ifdef TLS_SESSION_TICKETS
+int TlsTransport::ticketWrite(void *ctx, const mbedtls_ssl_session *session, unsigned char *start,
+                              const unsigned char *end, size_t *length, uint32_t *lifetime)
+{
+    return mbedtls_ssl_ticket_write(&((TlsTransport *)ctx)->_ticket, session, start, end, length, lifetime);
+}
+
+int TlsTransport::ticketParse(void *ctx, mbedtls_ssl_session *session, unsigned char *buf, size_t len)
+{
+    TlsTransport *self = (TlsTransport *)ctx;
+    int ret = mbedtls_ssl_ticket_parse(&self->_ticket, session, buf, len);
+    self->_resuming |= ret == 0;
+    return ret;
+}
+#endif
+
+// --- Funções Privadas ---
+
+// O socket do httpd é bloqueante com timeout (recv_wait_timeout): cada
+// WANT_READ/WANT_WRITE já esperou; tenta de novo até o limite total
+int TlsTransport::handshake(Connection &connection)
+{
+    unsigned long start = millis();
+    int ret;
+    while ((ret = mbedtls_ssl_handshake(&connection.ssl)) != 0)
+    {
+        if (ret != MBEDTLS_ERR_SSL_WANT_READ && ret != MBEDTLS_ERR_SSL_WANT_WRITE)
+            return ret;
+        if (millis() - start >= TLS_HANDSHAKE_TIMEOUT)
+            return ret;
+    }
+    return 0;
+}
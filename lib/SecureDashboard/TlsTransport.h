@@ -0,0 +1,129 @@
+#ifndef TLS_TRANSPORT_H
+#define TLS_TRANSPORT_H
+
+#include <Arduino.h>
+#include <esp_http_server.h>
+#include <mbedtls/ctr_drbg.h>
+#include <mbedtls/entropy.h>
+#include <mbedtls/net_sockets.h>
+#include <mbedtls/pk.h>
+#include <mbedtls/ssl.h>
+#include <mbedtls/version.h>
+#include <mbedtls/x509_crt.h>
+#if defined(MBEDTLS_SSL_CACHE_C)
+#include <mbedtls/ssl_cache.h>
+#endif
+// Tickets precisam do módulo (TICKET_C) e da extensão no handshake (SESSION_TICKETS)
+#if defined(MBEDTLS_SSL_TICKET_C) && defined(MBEDTLS_SSL_SESSION_TICKETS)
+#include <mbedtls/ssl_ticket.h>
+#define TLS_SESSION_TICKETS 1
+#endif
+
+// Sessões guardadas para a retomada por ID (~200 bytes de heap cada)
+#ifndef TLS_SESSION_CACHE_SIZE
+#define TLS_SESSION_CACHE_SIZE 8
+#endif
+
+// Validade de uma sessão retomável, no cache e nos tickets (segundos)
+#ifndef TLS_SESSION_LIFETIME
+#define TLS_SESSION_LIFETIME 86400
+#endif
+
+// Tempo máximo de um handshake (ms). Cada espera no socket já é limitada
+// pelo recv_wait_timeout do servidor.
+#ifndef TLS_HANDSHAKE_TIMEOUT
+#define TLS_HANDSHAKE_TIMEOUT 10000
+#endif
+
+/**
+ * TLS de um esp_http_server feito direto no mbedTLS, com retomada de sessão.
+ *
+ * O esp_https_server do IDF 4.4 (Arduino 2.x) não guarda sessões: cada
+ * conexão nova faz o handshake completo (ECDHE e assinatura, centenas de
+ * ms no ESP32). Aqui o handshake é feito no open_fn do servidor, com o
+ * cache de sessões por ID e os tickets (RFC 5077) do mbedTLS, o que o
+ * sdkconfig tiver (MBEDTLS_SSL_CACHE_C, MBEDTLS_SSL_TICKET_C). Uma
+ * conexão retomada pula a troca de chaves e a assinatura.
+ *
+ * Só a task do servidor usa o contexto (handshakes um de cada vez), então
+ * o cache não precisa de lock.
+ *
+ * Medição no PC (full x retomado x texto puro): tools/tls_bench.
+ */
+class TlsTransport
+{
+public:
+    TlsTransport();
+
+    /**
+     * @brief Lê certificado e chave (PEM, tamanho contando o '\0') e
+     * prepara a configuração. Os buffers podem ser liberados depois.
+     * @return false se o certificado ou a chave não são válidos.
+     */
+    bool begin(const uint8_t *cert, size_t certLength, const uint8_t *key, size_t keyLength);
+
+    /**
+     * @brief Liga o TLS na configuração de um servidor que ainda vai ser
+     * iniciado com httpd_start().
+     */
+    void install(httpd_config_t &config);
+
+    /**
+     * @brief Formas de retomada disponíveis neste build, para o log.
+     */
+    static const char *resumptionModes();
+
+    uint32_t fullHandshakes() const { return _fullHandshakes; }
+    uint32_t resumedHandshakes() const { return _resumedHandshakes; }
+
+private:
+    // Estado de uma conexão, guardado como transport_ctx da sessão do httpd
+    struct Connection
+    {
+        mbedtls_ssl_context ssl;
+        mbedtls_net_context net;
+    };
+
+    static esp_err_t openConnection(httpd_handle_t hd, int sockfd);
+    static void closeConnection(httpd_handle_t hd, int sockfd);
+    static void freeConnection(void *ctx);
+    static int tlsSend(httpd_handle_t hd, int sockfd, const char *buf, size_t len, int flags);
+    static int tlsRecv(httpd_handle_t hd, int sockfd, char *buf, size_t len, int flags);
+    static int tlsPending(httpd_handle_t hd, int sockfd);
+    static int toSocketResult(int ret);
+
+    // Repassam ao mbedTLS e anotam se o handshake atual é uma retomada
+#if defined(MBEDTLS_SSL_CACHE_C)
+#if MBEDTLS_VERSION_NUMBER >= 0x03000000
+    static int cacheGet(void *ctx, const unsigned char *id, size_t idLength, mbedtls_ssl_session *session);
+    static int cacheSet(void *ctx, const unsigned char *id, size_t idLength, const mbedtls_ssl_session *session);
+#else
+    static int cacheGet(void *ctx, mbedtls_ssl_session *session);
+    static int cacheSet(void *ctx, const mbedtls_ssl_session *session);
+#endif
+#endif
+#ifdef TLS_SESSION_TICKETS
+    static int ticketWrite(void *ctx, const mbedtls_ssl_session *session, unsigned char *start,
+                           const unsigned char *end, size_t *length, uint32_t *lifetime);
+    static int ticketParse(void *ctx, mbedtls_ssl_session *session, unsigned char *buf, size_t len);
+#endif
+
+    int handshake(Connection &connection);
+
+    mbedtls_entropy_context _entropy;
+    mbedtls_ctr_drbg_context _drbg;
+    mbedtls_x509_crt _cert;
+    mbedtls_pk_context _key;
+    mbedtls_ssl_config _config;
+#if defined(MBEDTLS_SSL_CACHE_C)
+    mbedtls_ssl_cache_context _cache;
+#endif
+#ifdef TLS_SESSION_TICKETS
+    mbedtls_ssl_ticket_context _ticket;
+#endif
+    bool _resuming; // O handshake em andamento achou a sessão no cache ou no ticket
+    uint32_t _fullHandshakes;
+    uint32_t _resumedHandshakes;
+};
+
+#endif // TLS_TRANSPORT_H
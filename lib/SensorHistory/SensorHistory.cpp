@@ -0,0 +1,273 @@
+#include "SensorHistory.h"
+#include <math.h>
+#include <stdlib.h>
+
+// Antes disso a hora ainda não veio do NTP
+static const time_t MIN_VALID_TIME = 1600000000;
+
+void HistoryNode::clear()
+{
+    for (int c = 0; c < HISTORY_CHANNELS; c++)
+    {
+        min[c] = INT16_MAX;
+        max[c] = INT16_MIN;
+        sum[c] = 0;
+        count[c] = 0;
+    }
+}
+
+void HistoryNode::merge(const HistoryNode &other)
+{
+    for (int c = 0; c < HISTORY_CHANNELS; c++)
+    {
+        if (other.min[c] < min[c])
+            min[c] = other.min[c];
+        if (other.max[c] > max[c])
+            max[c] = other.max[c];
+        sum[c] += other.sum[c];
+        count[c] += other.count[c];
+    }
+}
+
+bool HistoryNode::empty() const
+{
+    for (int c = 0; c < HISTORY_CHANNELS; c++)
+    {
+        if (count[c] > 0)
+            return false;
+    }
+    return true;
+}
+
+SensorHistory::SensorHistory()
+{
+    _nodes = nullptr;
+    _lastBucket = -1;
+}
+
+SensorHistory::~SensorHistory()
+{
+    free(_nodes);
+}
+
+bool SensorHistory::begin()
+{
+    if (_nodes == nullptr)
+    {
+        _nodes = (HistoryNode *)malloc(2 * HISTORY_BUCKETS * sizeof(HistoryNode));
+    }
+    if (_nodes == nullptr)
+        return false;
+
+    for (size_t i = 0; i < 2 * HISTORY_BUCKETS; i++)
+    {
+        _nodes[i].clear();
+    }
+    _lastBucket = -1;
+    return true;
+}
+
+void SensorHistory::appendClimate(time_t when, float temperature, float humidity)
+{
+    size_t leaf;
+    if (!openBucket(when, leaf))
+        return;
+    if (!isnan(temperature))
+        appendValue(leaf, HISTORY_TEMPERATURE, (int16_t)lroundf(temperature * 10));
+    if (!isnan(humidity))
+        appendValue(leaf, HISTORY_HUMIDITY, (int16_t)lroundf(humidity * 10));
+    update(leaf);
+}
+
+void SensorHistory::appendLight(time_t when, int luminosity)
+{
+    size_t leaf;
+    if (!openBucket(when, leaf))
+        return;
+    appendValue(leaf, HISTORY_LUMINOSITY, (int16_t)luminosity);
+    update(leaf);
+}
+
+bool SensorHistory::query(time_t from, time_t to, HistoryNode &out) const
+{
+    out.clear();
+    if (_nodes == nullptr || _lastBucket < 0 || to < from)
+        return false;
+
+    // Limita a faixa ao que ainda está no buffer (em 64 bits: time_t pode ter 64)
+    int64_t first = (int64_t)from / HISTORY_BUCKET_SECONDS;
+    int64_t last = (int64_t)to / HISTORY_BUCKET_SECONDS;
+    if (first < (int64_t)_lastBucket - HISTORY_BUCKETS + 1)
+        first = (int64_t)_lastBucket - HISTORY_BUCKETS + 1;
+    if (last > _lastBucket)
+        last = _lastBucket;
+    if (first > last)
+        return false;
+
+    size_t firstLeaf = first % HISTORY_BUCKETS;
+    size_t lastLeaf = last % HISTORY_BUCKETS;
+    if (firstLeaf <= lastLeaf)
+    {
+        queryLeaves(firstLeaf, lastLeaf, out);
+    }
+    else
+    {
+        // A faixa dá a volta no buffer circular
+        queryLeaves(firstLeaf, HISTORY_BUCKETS - 1, out);
+        queryLeaves(0, lastLeaf, out);
+    }
+    return !out.empty();
+}
+
+bool SensorHistory::plan(time_t from, time_t to, uint32_t step, HistoryRange &out) const
+{
+    out.from = from;
+    out.step = step;
+    out.points = 0;
+    if (step == 0 || from > to)
+        return false;
+    if (_lastBucket < 0)
+        return true; // Válida, mas ainda sem nada guardado
+
+    // Corta à janela guardada. Em 64 bits: from/to vêm da URL e podem estar
+    // perto dos limites do time_t (32 bits no ESP32).
+    int64_t windowStart = ((int64_t)_lastBucket - HISTORY_BUCKETS + 1) * HISTORY_BUCKET_SECONDS;
+    int64_t windowEnd = ((int64_t)_lastBucket + 1) * HISTORY_BUCKET_SECONDS - 1;
+    int64_t first = from < windowStart ? windowStart : (int64_t)from;
+    int64_t last = to > windowEnd ? windowEnd : (int64_t)to;
+    if (first > last)
+        return true;
+
+    // Pontos alinhados ao intervalo base, com passo múltiplo dele
+    first -= first % HISTORY_BUCKET_SECONDS;
+    uint64_t span = (uint64_t)(last - first) + 1;
+    uint64_t stride = step < HISTORY_BUCKET_SECONDS ? HISTORY_BUCKET_SECONDS : step;
+    if (stride > span)
+        stride = span; // Um ponto só: o fim do ponto não passa da janela
+    if (span / stride >= HISTORY_MAX_POINTS)
+        stride = (span + HISTORY_MAX_POINTS - 1) / HISTORY_MAX_POINTS;
+    stride = ((stride + HISTORY_BUCKET_SECONDS - 1) / HISTORY_BUCKET_SECONDS) * HISTORY_BUCKET_SECONDS;
+
+    out.from = (time_t)first;
+    out.step = (uint32_t)stride;
+    out.points = (uint32_t)((span + stride - 1) / stride);
+    return true;
+}
+
+#ifdef ARDUINO
+void SensorHistory::writeJson(Print &out, time_t from, time_t to, uint32_t step) const
+{
+    HistoryRange range;
+    plan(from, to, step, range);
+
+    out.printf("{\"inicio\":%ld,\"passo\":%u,", (long)range.from, (unsigned)range.step);
+    out.print("\"campos\":[\"temp_min\",\"temp_max\",\"temp_media\","
+              "\"hum_min\",\"hum_max\",\"hum_media\","
+              "\"lum_min\",\"lum_max\",\"lum_media\"],\"pontos\":[");
+
+    static const char *const format[HISTORY_CHANNELS] = {"%.1f,%.1f,%.1f", "%.1f,%.1f,%.1f", "%.0f,%.0f,%.0f"};
+    static const double scale[HISTORY_CHANNELS] = {10.0, 10.0, 1.0};
+
+    // Contador limitado por plan(): nunca soma perto do limite do time_t
+    for (uint32_t i = 0; i < range.points; i++)
+    {
+        if (i > 0)
+            out.print(",");
+
+        time_t t = range.from + (time_t)(i * range.step);
+        HistoryNode node;
+        if (!query(t, t + (time_t)(range.step - 1), node))
+        {
+            out.print("null");
+            continue;
+        }
+
+        // Canal sem leituras no ponto (sensor ausente ou com falha): null
+        out.print("[");
+        for (int c = 0; c < HISTORY_CHANNELS; c++)
+        {
+            if (c > 0)
+                out.print(",");
+            if (node.count[c] == 0)
+            {
+                out.print("null,null,null");
+                continue;
+            }
+            out.printf(format[c], node.min[c] / scale[c], node.max[c] / scale[c], node.average(c) / scale[c]);
+        }
+        out.print("]");
+    }
+    out.print("]}");
+}
+#endif
+
+// --- Funções Privadas ---
+
+// Acha a folha do intervalo de 'when', abrindo um intervalo novo se preciso
+bool SensorHistory::openBucket(time_t when, size_t &leaf)
+{
+    if (_nodes == nullptr || when < MIN_VALID_TIME)
+        return false;
+
+    int32_t bucket = when / HISTORY_BUCKET_SECONDS;
+    if (bucket < _lastBucket)
+        return false;
+
+    // Novo intervalo: limpa as folhas que ficaram para trás (sem dados)
+    if (bucket > _lastBucket)
+    {
+        int32_t first = _lastBucket + 1;
+        if (_lastBucket < 0 || bucket - first >= HISTORY_BUCKETS)
+            first = bucket - HISTORY_BUCKETS + 1;
+        for (int32_t b = first; b <= bucket; b++)
+        {
+            size_t cleared = b % HISTORY_BUCKETS;
+            _nodes[HISTORY_BUCKETS + cleared].clear();
+            update(cleared);
+        }
+        _lastBucket = bucket;
+        for (int c = 0; c < HISTORY_CHANNELS; c++)
+        {
+            _openSum[c] = 0;
+            _openCount[c] = 0;
+        }
+    }
+
+    leaf = bucket % HISTORY_BUCKETS;
+    return true;
+}
+
+// A folha aberta guarda min/max e a média parcial do intervalo, por canal
+void SensorHistory::appendValue(size_t leaf, int channel, int16_t value)
+{
+    HistoryNode &node = _nodes[HISTORY_BUCKETS + leaf];
+    _openSum[channel] += value;
+    _openCount[channel]++;
+    if (value < node.min[channel])
+        node.min[channel] = value;
+    if (value > node.max[channel])
+        node.max[channel] = value;
+    node.sum[channel] = _openSum[channel] / _openCount[channel];
+    node.count[channel] = 1;
+}
+
+void SensorHistory::update(size_t leaf)
+{
+    for (size_t i = (HISTORY_BUCKETS + leaf) / 2; i >= 1; i /= 2)
+    {
+        _nodes[i] = _nodes[2 * i];
+        _nodes[i].merge(_nodes[2 * i + 1]);
+    }
+}
+
+void SensorHistory::queryLeaves(size_t first, size_t last, HistoryNode &out) const
+{
+    // Árvore de segmentos iterativa: sobe pelos dois lados da faixa
+    for (size_t l = first + HISTORY_BUCKETS, r = last + HISTORY_BUCKETS + 1; l < r; l /= 2, r /= 2)
+    {
+        if (l & 1)
+            out.merge(_nodes[l++]);
+        if (r & 1)
+            out.merge(_nodes[--r]);
+    }
+}
@@ -0,0 +1,134 @@
+#ifndef SENSOR_HISTORY_H
+#define SENSOR_HISTORY_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+#ifdef ARDUINO
+#include <Arduino.h> // Print (writeJson); o resto roda também no env native
+#endif
+
+// Largura do menor intervalo guardado (segundos). As amostras de 5 s
+// são agregadas (min/max/soma) dentro dele.
+#ifndef HISTORY_BUCKET_SECONDS
+#define HISTORY_BUCKET_SECONDS 3600
+#endif
+
+// Quantidade de intervalos guardados (768 x 1 h = 32 dias)
+#ifndef HISTORY_BUCKETS
+#define HISTORY_BUCKETS 768
+#endif
+
+// Máximo de pontos por consulta; o passo é aumentado se preciso
+#ifndef HISTORY_MAX_POINTS
+#define HISTORY_MAX_POINTS 96
+#endif
+
+enum HistoryChannel
+{
+    HISTORY_TEMPERATURE, // x10
+    HISTORY_HUMIDITY,    // x10
+    HISTORY_LUMINOSITY,  // 0-4095
+    HISTORY_CHANNELS
+};
+
+/**
+ * Agregado de um intervalo de tempo: min/max das amostras e a soma das
+ * médias de cada intervalo base (count = intervalos com dados). A média
+ * é ponderada pelo tempo, não pelo número de leituras.
+ *
+ * Cada canal tem a sua contagem: o DHT e o LDR são lidos em ritmos
+ * diferentes, e um intervalo pode ter luz e não ter temperatura.
+ */
+struct HistoryNode
+{
+    int16_t min[HISTORY_CHANNELS];
+    int16_t max[HISTORY_CHANNELS];
+    int32_t sum[HISTORY_CHANNELS];
+    uint16_t count[HISTORY_CHANNELS];
+
+    void clear();
+    void merge(const HistoryNode &other);
+    bool empty() const;
+    float average(int channel) const { return count[channel] ? (float)sum[channel] / count[channel] : 0; }
+};
+
+/**
+ * Pontos de uma consulta por passo, já limitados ao que está guardado.
+ */
+struct HistoryRange
+{
+    time_t from;     // Início do primeiro ponto (alinhado ao intervalo base)
+    uint32_t step;   // Segundos por ponto (múltiplo do intervalo base)
+    uint32_t points; // 0 se a faixa não tem nada guardado
+};
+
+/**
+ * Histórico dos sensores com consultas rápidas por intervalo.
+ *
+ * Os intervalos ficam num buffer circular e, por cima deles, numa árvore
+ * de segmentos (2 x HISTORY_BUCKETS nós). Cada nova amostra atualiza só o
+ * caminho folha -> raiz, e qualquer faixa [from, to] é respondida lendo
+ * O(log n) nós, em vez de varrer todas as amostras.
+ */
+class SensorHistory
+{
+public:
+    SensorHistory();
+    ~SensorHistory();
+
+    /**
+     * @brief Aloca a árvore (~49 KB com os valores padrão).
+     * @return false se não houver memória.
+     */
+    bool begin();
+
+    /**
+     * @brief Adiciona uma leitura do DHT no intervalo de 'when'. Um valor
+     * NAN (leitura que falhou) não entra no canal.
+     * Ignorada se a hora ainda não foi sincronizada ou se for mais antiga
+     * que o intervalo aberto.
+     */
+    void appendClimate(time_t when, float temperature, float humidity);
+
+    /**
+     * @brief Adiciona uma leitura do LDR no intervalo de 'when' (mesmas regras).
+     */
+    void appendLight(time_t when, int luminosity);
+
+    /**
+     * @brief Agrega tudo o que existe entre from e to (inclusive).
+     * @return false se não houver amostras na faixa.
+     */
+    bool query(time_t from, time_t to, HistoryNode &out) const;
+
+    /**
+     * @brief Calcula os pontos de [from, to] a cada step segundos. A faixa
+     * é cortada à janela guardada e o passo é aumentado para no máximo
+     * HISTORY_MAX_POINTS pontos.
+     * @return false se step == 0 ou from > to.
+     */
+    bool plan(time_t from, time_t to, uint32_t step, HistoryRange &out) const;
+
+#ifdef ARDUINO
+    /**
+     * @brief Escreve em JSON os agregados de [from, to], um ponto a cada step segundos.
+     */
+    void writeJson(Print &out, time_t from, time_t to, uint32_t step) const;
+#endif
+
+private:
+    bool openBucket(time_t when, size_t &leaf);
+    void appendValue(size_t leaf, int channel, int16_t value);
+    void update(size_t leaf);
+    void queryLeaves(size_t first, size_t last, HistoryNode &out) const;
+
+    HistoryNode *_nodes; // _nodes[HISTORY_BUCKETS + i] = folha i
+    int32_t _lastBucket; // Intervalo mais recente (tempo / HISTORY_BUCKET_SECONDS)
+
+    // Soma das amostras do intervalo aberto (só ele recebe amostras novas)
+    int32_t _openSum[HISTORY_CHANNELS];
+    uint16_t _openCount[HISTORY_CHANNELS];
+};
+
+#endif // SENSOR_HISTORY_H
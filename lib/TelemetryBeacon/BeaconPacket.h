@@ -0,0 +1,138 @@
+#ifndef BEACON_PACKET_H
+#define BEACON_PACKET_H
+
+// Formato do datagrama de status enviado por multicast (TelemetryBeacon).
+// Só usa a biblioteca padrão: o mesmo arquivo é usado no firmware e nas
+// ferramentas Linux (tools/).
+//
+// Layout v1 (little-endian, 36 bytes):
+//   0  u32  magic "PLDB"
+//   4  u8   versão
+//   5  u8   flags (BEACON_FLAG_*)
+//   6  u16  tamanho do pacote
+//   8  u32  id do dispositivo (4 últimos bytes do MAC: getEfuseMac() >> 16)
+//  12  u32  número de sequência (detecta perdas)
+//  16  u32  uptime (s)
+//  20  i16  temperatura x10 (C), BEACON_NO_TEMPERATURE sem leitura
+//  22  u16  humidade x10 (%), BEACON_NO_HUMIDITY sem leitura
+//  24  u16  luminosidade (0-4095)
+//  26  u16  PWM atual
+//  28  u16  hora de ligar (minutos desde 00:00)
+//  30  u16  hora de desligar (minutos desde 00:00)
+//  32  u8   luz máxima (%)
+//  33  u8   reservado
+//  34  u16  reservado
+//
+// Versões novas só acrescentam campos no fim: um leitor v1 aceita
+// pacotes maiores de versão >= 1 e ignora o resto.
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define BEACON_MAGIC 0x42444C50UL // "PLDB" lido como u32 little-endian
+#define BEACON_VERSION 1
+#define BEACON_PACKET_SIZE 36
+
+#define BEACON_FLAG_CHANGE 0x01    // Enviado por mudança de estado (não pelo timer)
+#define BEACON_FLAG_TIME_SYNC 0x02 // Hora do NTP válida
+
+#define BEACON_NO_TEMPERATURE INT16_MIN // Sensor ausente ou leitura falhou
+#define BEACON_NO_HUMIDITY UINT16_MAX
+
+struct BeaconStatus
+{
+    uint8_t version;
+    uint8_t flags;
+    uint32_t deviceId;
+    uint32_t sequence;
+    uint32_t uptime;
+    int16_t temperature; // x10
+    uint16_t humidity;   // x10
+    uint16_t luminosity;
+    uint16_t pwm;
+    uint16_t onMinutes;
+    uint16_t offMinutes;
+    uint8_t maxLight;
+};
+
+namespace beacon_detail
+{
+    inline void put16(uint8_t *p, uint16_t v)
+    {
+        p[0] = v & 0xFF;
+        p[1] = v >> 8;
+    }
+    inline void put32(uint8_t *p, uint32_t v)
+    {
+        put16(p, v & 0xFFFF);
+        put16(p + 2, v >> 16);
+    }
+    inline uint16_t get16(const uint8_t *p)
+    {
+        return (uint16_t)(p[0] | (p[1] << 8));
+    }
+    inline uint32_t get32(const uint8_t *p)
+    {
+        return get16(p) | ((uint32_t)get16(p + 2) << 16);
+    }
+}
+
+/**
+ * @brief Codifica o status no buffer.
+ * @return Bytes escritos (BEACON_PACKET_SIZE) ou 0 se o buffer for pequeno.
+ */
+inline size_t beaconEncode(const BeaconStatus &status, uint8_t *out, size_t size)
+{
+    using namespace beacon_detail;
+    if (size < BEACON_PACKET_SIZE)
+        return 0;
+
+    put32(out + 0, BEACON_MAGIC);
+    out[4] = BEACON_VERSION;
+    out[5] = status.flags;
+    put16(out + 6, BEACON_PACKET_SIZE);
+    put32(out + 8, status.deviceId);
+    put32(out + 12, status.sequence);
+    put32(out + 16, status.uptime);
+    put16(out + 20, (uint16_t)status.temperature);
+    put16(out + 22, status.humidity);
+    put16(out + 24, status.luminosity);
+    put16(out + 26, status.pwm);
+    put16(out + 28, status.onMinutes);
+    put16(out + 30, status.offMinutes);
+    out[32] = status.maxLight;
+    out[33] = 0;
+    put16(out + 34, 0);
+    return BEACON_PACKET_SIZE;
+}
+
+/**
+ * @brief Decodifica e valida um datagrama.
+ * @return false se não for um pacote de status válido.
+ */
+inline bool beaconDecode(const uint8_t *data, size_t len, BeaconStatus &status)
+{
+    using namespace beacon_detail;
+    if (len < BEACON_PACKET_SIZE || get32(data) != BEACON_MAGIC || data[4] < 1)
+        return false;
+
+    uint16_t declared = get16(data + 6);
+    if (declared < BEACON_PACKET_SIZE || declared > len)
+        return false;
+
+    status.version = data[4];
+    status.flags = data[5];
+    status.deviceId = get32(data + 8);
+    status.sequence = get32(data + 12);
+    status.uptime = get32(data + 16);
+    status.temperature = (int16_t)get16(data + 20);
+    status.humidity = get16(data + 22);
+    status.luminosity = get16(data + 24);
+    status.pwm = get16(data + 26);
+    status.onMinutes = get16(data + 28);
+    status.offMinutes = get16(data + 30);
+    status.maxLight = data[32];
+    return true;
+}
+
+#endif // BEACON_PACKET_H
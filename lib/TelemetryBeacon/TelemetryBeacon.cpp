@@ -0,0 +1,115 @@
+#include "TelemetryBeacon.h"
+#include "time.h"
+
+// Antes disso a hora ainda não veio do NTP
+static const time_t MIN_VALID_TIME = 1600000000;
+
+/**
+ * @brief Converte "HH:MM" para minutos (0 se inválido).
+ */
+static uint16_t minutesOf(const char *hh_mm)
+{
+    if (hh_mm == nullptr || strlen(hh_mm) != 5)
+        return 0;
+    return ((hh_mm[0] - '0') * 10 + (hh_mm[1] - '0')) * 60 + (hh_mm[3] - '0') * 10 + (hh_mm[4] - '0');
+}
+
+TelemetryBeacon::TelemetryBeacon()
+    : _arena(_arenaBuffer, sizeof(_arenaBuffer))
+{
+    _dataCallback = nullptr;
+    _port = 0;
+    _interval = 10000;
+    _lastSend = 0;
+    _sequence = 0;
+    _deviceId = 0;
+    _pending = false;
+    _started = false;
+}
+
+void TelemetryBeacon::begin(IPAddress group, uint16_t port, unsigned long interval)
+{
+    _group = group;
+    _port = port;
+    _interval = interval;
+    _deviceId = deviceId();
+    _started = true;
+    _pending = true; // Primeiro pacote logo ao iniciar
+
+    LOG_I("[Beacon] Enviando status para %s:%u a cada %lu ms.\n",
+          _group.toString().c_str(), _port, _interval);
+}
+
+void TelemetryBeacon::onDataRequest(DataCallback callback)
+{
+    _dataCallback = callback;
+}
+
+void TelemetryBeacon::notifyChange()
+{
+    _pending = true;
+}
+
+void TelemetryBeacon::loop(bool link_up)
+{
+    if (!_started || !link_up)
+        return;
+
+    unsigned long elapsed = millis() - _lastSend;
+    if (_pending && elapsed >= BEACON_MIN_GAP)
+    {
+        send(true);
+    }
+    else if (elapsed >= _interval)
+    {
+        send(false);
+    }
+}
+
+// --- Funções Privadas ---
+
+void TelemetryBeacon::send(bool change)
+{
+    _lastSend = millis();
+    _pending = false;
+
+    if (_dataCallback == nullptr)
+        return;
+
+    // Mesmo modelo de dados do /data.json, no buffer do objeto (sem heap)
+    _arena.reset();
+    JsonDocument doc(&_arena);
+    _dataCallback(doc);
+    if (doc.overflowed())
+    {
+        LOG_W("[Beacon] Dados maiores que BEACON_ARENA_SIZE; pacote %u descartado.\n", (unsigned)_sequence);
+        return;
+    }
+
+    BeaconStatus status;
+    status.flags = (change ? BEACON_FLAG_CHANGE : 0) |
+                   (time(nullptr) >= MIN_VALID_TIME ? BEACON_FLAG_TIME_SYNC : 0);
+    status.deviceId = _deviceId;
+    status.sequence = _sequence++;
+    status.uptime = millis() / 1000;
+    // null (sensor ausente ou sem leitura) vira o valor "sem leitura", não 0
+    JsonVariantConst temperature = doc["temperatura"];
+    JsonVariantConst humidity = doc["humidade"];
+    status.temperature = temperature.is<float>() ? (int16_t)lroundf(temperature.as<float>() * 10) : BEACON_NO_TEMPERATURE;
+    status.humidity = humidity.is<float>() ? (uint16_t)lroundf(humidity.as<float>() * 10) : BEACON_NO_HUMIDITY;
+    status.luminosity = doc["luminosidade"].as<uint16_t>(); // O layout v1 não tem "sem leitura": 0
+    status.pwm = doc["pwm"].as<uint16_t>();
+    status.onMinutes = minutesOf(doc["hora_ligar"].as<const char *>());
+    status.offMinutes = minutesOf(doc["hora_desligar"].as<const char *>());
+    status.maxLight = doc["luz_maxima"].as<uint8_t>();
+
+    uint8_t packet[BEACON_PACKET_SIZE];
+    size_t len = beaconEncode(status, packet, sizeof(packet));
+
+    if (!_udp.beginPacket(_group, _port) ||
+        _udp.write(packet, len) != len ||
+        !_udp.endPacket())
+    {
+        LOG_D("[Beacon] Falha ao enviar pacote %u.\n", (unsigned)status.sequence);
+    }
+}
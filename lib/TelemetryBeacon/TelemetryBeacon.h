@@ -0,0 +1,80 @@
+#ifndef TELEMETRY_BEACON_H
+#define TELEMETRY_BEACON_H
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <WiFiUdp.h>
+#include <ArduinoJson.h>
+#include "AsyncLog.h"
+#include "DashboardServer.h" // Reutiliza o DataCallback (mesmo modelo de dados do /data.json)
+#include "RequestArena.h"
+#include "BeaconPacket.h"
+
+// Intervalo mínimo entre dois pacotes, mesmo com mudanças seguidas (ms)
+#ifndef BEACON_MIN_GAP
+#define BEACON_MIN_GAP 200
+#endif
+
+// Buffer do JsonDocument de cada envio (o mesmo modelo do /data.json, sem data/hora)
+#ifndef BEACON_ARENA_SIZE
+#define BEACON_ARENA_SIZE 1024
+#endif
+
+/**
+ * Envia o status do dispositivo num datagrama UDP multicast de formato fixo
+ * (BeaconPacket.h), em intervalo configurável e logo após uma mudança de
+ * estado (PWM ou configurações).
+ */
+class TelemetryBeacon
+{
+public:
+    TelemetryBeacon();
+
+    /**
+     * @brief Inicia o envio.
+     * @param group Grupo multicast (ex: 239.255.42.99).
+     * @param port Porta UDP de destino.
+     * @param interval Intervalo (ms) entre pacotes periódicos.
+     */
+    void begin(IPAddress group, uint16_t port, unsigned long interval);
+
+    /**
+     * @brief Registra a função que preenche os dados (mesma do /data.json).
+     */
+    void onDataRequest(DataCallback callback);
+
+    /**
+     * @brief Pede um pacote imediato (respeitando BEACON_MIN_GAP).
+     */
+    void notifyChange();
+
+    /**
+     * @brief Função de loop. Deve ser chamada em cada loop() do sketch principal.
+     * @param link_up true se o Wi-Fi está conectado.
+     */
+    void loop(bool link_up);
+
+    /**
+     * @brief Id do dispositivo: os 4 últimos bytes do MAC (os 3 primeiros
+     * são o fabricante, iguais em todas as placas).
+     */
+    static uint32_t deviceId() { return (uint32_t)(ESP.getEfuseMac() >> 16); }
+
+private:
+    void send(bool change);
+
+    WiFiUDP _udp;
+    DataCallback _dataCallback;
+    uint8_t _arenaBuffer[BEACON_ARENA_SIZE]; // Sem heap a cada envio
+    RequestArena _arena;
+    IPAddress _group;
+    uint16_t _port;
+    unsigned long _interval;
+    unsigned long _lastSend;
+    uint32_t _sequence;
+    uint32_t _deviceId;
+    bool _pending;
+    bool _started;
+};
+
+#endif // TELEMETRY_BEACON_H
@@ -0,0 +1,317 @@
+#include "TelemetryPublisher.h"
+#include "time.h"
+#include <esp_partition.h>
+#include <esp_idf_version.h>
+#include <nvs.h>
+
+// Intervalo entre tentativas de conexão com o broker: começa em 5 s e
+// dobra a cada falha, até 5 min
+static const unsigned long MQTT_RECONNECT_MIN = 5000;
+static const unsigned long MQTT_RECONNECT_MAX = 300000;
+
+// Tempo máximo do connect() TCP ao broker. O padrão do WiFiClient (3 s)
+// seguraria o loop() a cada tentativa com o broker fora.
+static const int32_t MQTT_CONNECT_TIMEOUT = 500;
+
+// Antes disto o relógio ainda não foi acertado pelo NTP (conta desde 1970)
+static const time_t MIN_VALID_TIME = 1600000000;
+
+// Geometria da NVS: páginas de 4 KB com 126 entradas de 32 bytes. Uma
+// página fica livre para a coleta de lixo da NVS. Um blob ocupa uma
+// entrada por 32 bytes de dados, mais o cabeçalho do pedaço e o índice.
+static const uint32_t NVS_PAGE_SIZE = 4096;
+static const uint32_t NVS_ENTRIES_PER_PAGE = 126;
+static const uint32_t NVS_ENTRIES_PER_BATCH = (TELEMETRY_MAX_PAYLOAD + 31) / 32 + 3;
+
+/**
+ * @brief Monta a chave NVS de um lote ("b<índice>").
+ */
+static void spoolKey(char *key, size_t size, uint32_t index)
+{
+    snprintf(key, size, "b%u", (unsigned)index);
+}
+
+TelemetryPublisher::TelemetryPublisher(const char *client_id)
+    : _mqtt(_net), _arena(_arenaBuffer, sizeof(_arenaBuffer)), _clientId(client_id)
+{
+    _dataCallback = nullptr;
+    _timeValid = false;
+    _sampleCount = 0;
+    _port = 1883;
+    _started = false;
+    _linkUp = false;
+    _flushInterval = 60000;
+    _lastFlush = 0;
+    _lastConnectAttempt = 0;
+    _reconnectDelay = 0;
+}
+
+void TelemetryPublisher::begin(const char *host, uint16_t port, const char *topic, unsigned long flush_interval)
+{
+    _host = host;
+    _port = port;
+    _topic = topic;
+    _flushInterval = flush_interval;
+
+    _mqtt.setServer(_host.c_str(), _port);
+    _mqtt.setBufferSize(TELEMETRY_MAX_PAYLOAD + 64); // Payload + cabeçalho MQTT
+    _mqtt.setSocketTimeout(2);                        // Espera do CONNACK e das leituras
+
+    openSpool();
+
+    _lastFlush = millis();
+    _started = true;
+    LOG_I("[MQTT] Telemetria iniciada para %s:%u (%u lotes pendentes na flash).\n",
+          _host.c_str(), _port, (unsigned)_spool.pending());
+}
+
+void TelemetryPublisher::onDataRequest(DataCallback callback)
+{
+    _dataCallback = callback;
+}
+
+void TelemetryPublisher::sample()
+{
+    if (!_started || _dataCallback == nullptr)
+        return;
+
+    // Sem NTP a linha sairia com um horário de 1970, indistinguível de dado real
+    time_t now = time(nullptr);
+    if (now < MIN_VALID_TIME)
+    {
+        if (_timeValid)
+            LOG_W("[MQTT] Hora perdida. Amostras suspensas ate o NTP.\n");
+        _timeValid = false;
+        return;
+    }
+    if (!_timeValid)
+    {
+        LOG_I("[MQTT] Hora sincronizada. Amostras liberadas.\n");
+        _timeValid = true;
+    }
+
+    // 1. Pede os valores atuais ao main.cpp (mesmo callback do /data.json),
+    //    no buffer do objeto (sem heap)
+    _arena.reset();
+    JsonDocument current(&_arena);
+    _dataCallback(current);
+    if (current.overflowed())
+    {
+        LOG_W("[MQTT] Dados maiores que TELEMETRY_ARENA_SIZE. Amostra descartada.\n");
+        return;
+    }
+    JsonObject fields = current.as<JsonObject>();
+
+    // 2. A primeira amostra do lote define a ordem das chaves
+    if (_sampleCount == 0)
+    {
+        _batch.clear();
+        _batch["v"] = 1;
+        JsonArray keys = _batch["k"].to<JsonArray>();
+        for (JsonPair kv : fields)
+        {
+            keys.add(kv.key());
+        }
+        _batch["s"].to<JsonArray>();
+    }
+
+    // 3. Cada amostra é só uma lista de valores: [t, v1, v2, ...]
+    JsonArray row = _batch["s"].as<JsonArray>().add<JsonArray>();
+    row.add((uint32_t)now);
+    for (JsonVariant key : _batch["k"].as<JsonArray>())
+    {
+        row.add(fields[key.as<const char *>()]);
+    }
+    _sampleCount++;
+
+    if (_sampleCount >= TELEMETRY_MAX_SAMPLES ||
+        measureMsgPack(_batch) > TELEMETRY_MAX_PAYLOAD * 3 / 4)
+    {
+        flush();
+    }
+}
+
+void TelemetryPublisher::notifyStateChange()
+{
+    sample();
+}
+
+void TelemetryPublisher::loop(bool link_up)
+{
+    if (!_started)
+        return;
+
+    _linkUp = link_up;
+
+    if (_linkUp && ensureConnected())
+    {
+        _mqtt.loop();
+        drainSpool();
+    }
+
+    if (millis() - _lastFlush > _flushInterval)
+    {
+        flush();
+    }
+}
+
+// --- Funções Privadas ---
+
+void TelemetryPublisher::flush()
+{
+    _lastFlush = millis();
+    if (_sampleCount == 0)
+        return;
+
+    uint8_t payload[TELEMETRY_MAX_PAYLOAD];
+    size_t len = serializeMsgPack(_batch, payload, sizeof(payload));
+    _sampleCount = 0;
+    _batch.clear();
+
+    if (len == 0 || len >= sizeof(payload))
+    {
+        LOG_W("[MQTT] Lote maior que o buffer. Descartado.\n");
+        return;
+    }
+
+    switch (_spool.submit(payload, len))
+    {
+    case TelemetrySpool::QUEUED_EVICTED:
+        LOG_W("[MQTT] Fila cheia. Lote mais antigo descartado.\n");
+        break;
+    case TelemetrySpool::DROPPED:
+        LOG_W("[MQTT] Sem fila na flash. Lote descartado.\n");
+        break;
+    case TelemetrySpool::STORE_FAILED:
+        LOG_W("[MQTT] Falha ao gravar lote na flash.\n");
+        break;
+    default:
+        break;
+    }
+}
+
+void TelemetryPublisher::drainSpool()
+{
+    // Contrapressão: no máximo um lote por chamada do loop(), e para
+    // na primeira falha para não segurar o HTTP e o PWM.
+    if (_spool.empty())
+        return;
+
+    uint8_t payload[TELEMETRY_MAX_PAYLOAD];
+    if (_spool.drainOne(payload, sizeof(payload)) && _spool.empty())
+    {
+        LOG_I("[MQTT] Fila da flash esvaziada.\n");
+    }
+}
+
+bool TelemetryPublisher::publishBatch(void *ctx, const uint8_t *payload, size_t len)
+{
+    TelemetryPublisher *self = (TelemetryPublisher *)ctx;
+    if (!self->_linkUp || !self->_mqtt.connected())
+        return false;
+    return self->_mqtt.publish(self->_topic.c_str(), payload, len, false);
+}
+
+bool TelemetryPublisher::storePut(void *ctx, uint32_t index, const uint8_t *data, size_t len)
+{
+    char key[16];
+    spoolKey(key, sizeof(key), index);
+    return ((TelemetryPublisher *)ctx)->_nvs.putBytes(key, data, len) == len;
+}
+
+size_t TelemetryPublisher::storeGet(void *ctx, uint32_t index, uint8_t *data, size_t size)
+{
+    char key[16];
+    spoolKey(key, sizeof(key), index);
+    return ((TelemetryPublisher *)ctx)->_nvs.getBytes(key, data, size);
+}
+
+void TelemetryPublisher::storeRemove(void *ctx, uint32_t index)
+{
+    char key[16];
+    spoolKey(key, sizeof(key), index);
+    ((TelemetryPublisher *)ctx)->_nvs.remove(key);
+}
+
+// Abre a fila na partição própria, calcula a capacidade pelo tamanho da
+// partição e refaz a cabeça/cauda a partir das chaves gravadas.
+void TelemetryPublisher::openSpool()
+{
+    SpoolStore store = {this, storePut, storeGet, storeRemove};
+    _spool.begin(store, 0, 0, 0, publishBatch, this);
+
+    const esp_partition_t *partition = esp_partition_find_first(
+        ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_DATA_NVS, TELEMETRY_SPOOL_PARTITION);
+    if (partition == nullptr || !_nvs.begin("telemetry-q", false, TELEMETRY_SPOOL_PARTITION))
+    {
+        LOG_W("[MQTT] Particao \"%s\" ausente. Lotes offline serao descartados.\n", TELEMETRY_SPOOL_PARTITION);
+        return;
+    }
+
+    uint32_t pages = partition->size / NVS_PAGE_SIZE;
+    uint32_t capacity = pages > 1 ? (pages - 1) * NVS_ENTRIES_PER_PAGE / NVS_ENTRIES_PER_BATCH : 0;
+
+    // Menor e maior índice gravados
+    uint32_t head = 0;
+    uint32_t tail = 0;
+    bool found = false;
+#if ESP_IDF_VERSION_MAJOR >= 5
+    nvs_iterator_t it = nullptr;
+    esp_err_t err = nvs_entry_find(TELEMETRY_SPOOL_PARTITION, "telemetry-q", NVS_TYPE_BLOB, &it);
+    while (err == ESP_OK)
+#else
+    nvs_iterator_t it = nvs_entry_find(TELEMETRY_SPOOL_PARTITION, "telemetry-q", NVS_TYPE_BLOB);
+    while (it != nullptr)
+#endif
+    {
+        nvs_entry_info_t info;
+        nvs_entry_info(it, &info);
+        if (info.key[0] == 'b')
+        {
+            uint32_t index = strtoul(info.key + 1, nullptr, 10);
+            if (!found || index < head)
+                head = index;
+            if (!found || index + 1 > tail)
+                tail = index + 1;
+            found = true;
+        }
+#if ESP_IDF_VERSION_MAJOR >= 5
+        err = nvs_entry_next(&it);
+#else
+        it = nvs_entry_next(it);
+#endif
+    }
+    nvs_release_iterator(it);
+
+    if (tail - head > capacity)
+    {
+        // Buraco nos índices (ex: NVS corrompida): descarta a fila
+        head = tail = 0;
+        _nvs.clear();
+    }
+    _spool.begin(store, capacity, head, tail, publishBatch, this);
+}
+
+bool TelemetryPublisher::ensureConnected()
+{
+    if (_mqtt.connected())
+        return true;
+
+    if (millis() - _lastConnectAttempt < _reconnectDelay)
+        return false;
+    _lastConnectAttempt = millis();
+
+    // Abre o TCP com timeout curto; o PubSubClient reaproveita a conexão aberta
+    if (_net.connect(_host.c_str(), _port, MQTT_CONNECT_TIMEOUT) && _mqtt.connect(_clientId.c_str()))
+    {
+        LOG_I("[MQTT] Conectado ao broker.\n");
+        _reconnectDelay = 0;
+        return true;
+    }
+    _net.stop();
+
+    _reconnectDelay = _reconnectDelay == 0 ? MQTT_RECONNECT_MIN : min(_reconnectDelay * 2, MQTT_RECONNECT_MAX);
+    LOG_W("[MQTT] Falha ao conectar (estado %d). Nova tentativa em %lu s.\n",
+          _mqtt.state(), _reconnectDelay / 1000);
+    return false;
+}
@@ -0,0 +1,120 @@
+#ifndef TELEMETRY_PUBLISHER_H
+#define TELEMETRY_PUBLISHER_H
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <PubSubClient.h>
+#include <Preferences.h>
+#include <ArduinoJson.h>
+#include "AsyncLog.h"
+#include "DashboardServer.h" // Reutiliza o DataCallback (mesmo modelo de dados do /data.json)
+#include "RequestArena.h"
+#include "TelemetrySpool.h"
+
+// Número máximo de amostras num lote antes de forçar o envio
+#ifndef TELEMETRY_MAX_SAMPLES
+#define TELEMETRY_MAX_SAMPLES 32
+#endif
+
+// Tamanho máximo (bytes) de um lote codificado (MessagePack)
+#ifndef TELEMETRY_MAX_PAYLOAD
+#define TELEMETRY_MAX_PAYLOAD 1536
+#endif
+
+// Buffer do JsonDocument de cada amostra (o mesmo modelo do /data.json)
+#ifndef TELEMETRY_ARENA_SIZE
+#define TELEMETRY_ARENA_SIZE 1024
+#endif
+
+// Partição NVS própria da fila (partitions.csv). Separada da NVS padrão
+// para que a fila cheia não impeça salvar as configurações e o Wi-Fi.
+// A capacidade da fila é calculada a partir do tamanho da partição.
+#ifndef TELEMETRY_SPOOL_PARTITION
+#define TELEMETRY_SPOOL_PARTITION "telemetria"
+#endif
+
+class TelemetryPublisher
+{
+public:
+    /**
+     * @brief Construtor da classe.
+     * @param client_id Identificador usado na conexão com o broker MQTT.
+     */
+    TelemetryPublisher(const char *client_id = "ESP32-Luz");
+
+    /**
+     * @brief Configura o broker e inicia o envio periódico dos lotes.
+     * @param host Endereço do broker MQTT.
+     * @param port Porta do broker MQTT.
+     * @param topic Tópico onde os lotes são publicados.
+     * @param flush_interval Intervalo (ms) entre envios de lote.
+     */
+    void begin(const char *host, uint16_t port, const char *topic, unsigned long flush_interval);
+
+    /**
+     * @brief Registra a função que preenche uma amostra.
+     * É o mesmo callback usado pelo DashboardServer::onDataRequest().
+     */
+    void onDataRequest(DataCallback callback);
+
+    /**
+     * @brief Adiciona uma amostra ao lote atual (ex: após ler os sensores).
+     * Ignorada até o NTP acertar a hora: a linha não teria um horário válido.
+     */
+    void sample();
+
+    /**
+     * @brief Registra uma mudança de estado (PWM, configurações).
+     * A amostra é adicionada imediatamente ao lote.
+     */
+    void notifyStateChange();
+
+    /**
+     * @brief Função de loop. Deve ser chamada em cada loop() do sketch principal.
+     * @param link_up true se o Wi-Fi está conectado.
+     */
+    void loop(bool link_up);
+
+private:
+    void flush();
+    void drainSpool();
+    void openSpool();
+    bool ensureConnected();
+
+    // Ligações do TelemetrySpool com o MQTT e a NVS
+    static bool publishBatch(void *ctx, const uint8_t *payload, size_t len);
+    static bool storePut(void *ctx, uint32_t index, const uint8_t *data, size_t len);
+    static size_t storeGet(void *ctx, uint32_t index, uint8_t *data, size_t size);
+    static void storeRemove(void *ctx, uint32_t index);
+
+    WiFiClient _net;
+    PubSubClient _mqtt;
+    Preferences _nvs;
+    DataCallback _dataCallback;
+    uint8_t _arenaBuffer[TELEMETRY_ARENA_SIZE]; // Sem heap a cada amostra
+    RequestArena _arena;
+    bool _timeValid; // Já viu a hora do NTP (só para o log)
+
+    // --- Lote atual ---
+    // Formato: {"v":1,"k":[chaves...],"s":[[t, valores...], ...]}
+    JsonDocument _batch;
+    size_t _sampleCount;
+
+    // --- Fila na flash ---
+    // Cada lote é a chave "b<índice>", com índices monotônicos. A cabeça e a
+    // cauda não são gravadas: são refeitas varrendo as chaves no begin().
+    TelemetrySpool _spool;
+
+    String _clientId;
+    String _host;
+    uint16_t _port;
+    String _topic;
+    bool _started;
+    bool _linkUp;
+    unsigned long _flushInterval;
+    unsigned long _lastFlush;
+    unsigned long _lastConnectAttempt;
+    unsigned long _reconnectDelay; // Cresce a cada falha (backoff exponencial)
+};
+
+#endif // TELEMETRY_PUBLISHER_H
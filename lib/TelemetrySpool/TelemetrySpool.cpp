@@ -0,0 +1,64 @@
+#include "TelemetrySpool.h"
+
+TelemetrySpool::TelemetrySpool()
+{
+    _store = SpoolStore{nullptr, nullptr, nullptr, nullptr};
+    _publisher = nullptr;
+    _publisherCtx = nullptr;
+    _capacity = 0;
+    _head = 0;
+    _tail = 0;
+    _evicted = 0;
+}
+
+void TelemetrySpool::begin(const SpoolStore &store, uint32_t capacity, uint32_t head, uint32_t tail,
+                           BatchPublisher publisher, void *publisherCtx)
+{
+    _store = store;
+    _capacity = capacity;
+    _head = head;
+    _tail = tail;
+    _publisher = publisher;
+    _publisherCtx = publisherCtx;
+}
+
+TelemetrySpool::Result TelemetrySpool::submit(const uint8_t *payload, size_t len)
+{
+    // Se há lotes antigos na fila, o novo entra atrás deles para manter a ordem
+    if (empty() && _publisher(_publisherCtx, payload, len))
+        return PUBLISHED;
+
+    if (_capacity == 0)
+        return DROPPED;
+
+    // Fila cheia: descarta o lote mais antigo
+    Result result = QUEUED;
+    if (_tail - _head >= _capacity)
+    {
+        _store.remove(_store.ctx, _head);
+        _head++;
+        _evicted++;
+        result = QUEUED_EVICTED;
+    }
+
+    // Uma única escrita por lote: nada de índices de cabeça/cauda gravados
+    if (!_store.put(_store.ctx, _tail, payload, len))
+        return STORE_FAILED;
+    _tail++;
+    return result;
+}
+
+bool TelemetrySpool::drainOne(uint8_t *buffer, size_t size)
+{
+    if (empty())
+        return false;
+
+    size_t len = _store.get(_store.ctx, _head, buffer, size);
+    if (len > 0 && !_publisher(_publisherCtx, buffer, len))
+        return false; // Tenta de novo na próxima chamada
+
+    // Publicado (ou entrada ilegível): avança a cabeça da fila
+    _store.remove(_store.ctx, _head);
+    _head++;
+    return true;
+}
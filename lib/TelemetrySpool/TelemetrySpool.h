@@ -0,0 +1,79 @@
+#ifndef TELEMETRY_SPOOL_H
+#define TELEMETRY_SPOOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Envia um lote ao broker; false se não conseguiu (sem conexão, erro)
+typedef bool (*BatchPublisher)(void *ctx, const uint8_t *payload, size_t len);
+
+/**
+ * Onde os lotes ficam guardados, um por índice (NVS no ESP32, memória nos testes).
+ */
+struct SpoolStore
+{
+    void *ctx;
+    bool (*put)(void *ctx, uint32_t index, const uint8_t *data, size_t len);
+    size_t (*get)(void *ctx, uint32_t index, uint8_t *data, size_t size); // 0 = ausente
+    void (*remove)(void *ctx, uint32_t index);
+};
+
+/**
+ * Fila de lotes de telemetria para quando o broker está fora.
+ *
+ * Um lote novo só vai direto ao broker se a fila está vazia; senão entra
+ * atrás dos antigos, então o broker recebe os lotes na ordem em que foram
+ * gerados. Com a fila cheia, o lote mais antigo é descartado. Os índices
+ * crescem sempre; cabeça e cauda são refeitas pelo dono ao reiniciar.
+ *
+ * Só usa a biblioteca padrão: roda no ESP32 e nos testes do env native.
+ */
+class TelemetrySpool
+{
+public:
+    enum Result
+    {
+        PUBLISHED,      // Foi direto ao broker
+        QUEUED,         // Guardado na fila
+        QUEUED_EVICTED, // Guardado, descartando o mais antigo (fila cheia)
+        DROPPED,        // Sem fila (capacidade 0) e sem broker
+        STORE_FAILED,   // Falha ao gravar: lote perdido
+    };
+
+    TelemetrySpool();
+
+    /**
+     * @param capacity Lotes que cabem no armazenamento (0 = fila desativada).
+     * @param head, tail Índices do primeiro lote guardado e do próximo livre.
+     */
+    void begin(const SpoolStore &store, uint32_t capacity, uint32_t head, uint32_t tail,
+               BatchPublisher publisher, void *publisherCtx);
+
+    /**
+     * @brief Entrega um lote novo: publica ou guarda na fila.
+     */
+    Result submit(const uint8_t *payload, size_t len);
+
+    /**
+     * @brief Tenta publicar o lote mais antigo da fila. Um por chamada.
+     * @param buffer Área para ler o lote (do tamanho do maior lote).
+     * @return true se o lote saiu da fila (publicado ou ilegível).
+     */
+    bool drainOne(uint8_t *buffer, size_t size);
+
+    bool empty() const { return _head == _tail; }
+    uint32_t pending() const { return _tail - _head; }
+    uint32_t capacity() const { return _capacity; }
+    uint32_t evicted() const { return _evicted; } // Lotes descartados com a fila cheia
+
+private:
+    SpoolStore _store;
+    BatchPublisher _publisher;
+    void *_publisherCtx;
+    uint32_t _capacity;
+    uint32_t _head;
+    uint32_t _tail;
+    uint32_t _evicted;
+};
+
+#endif // TELEMETRY_SPOOL_H
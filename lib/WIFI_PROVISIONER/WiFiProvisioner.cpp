@@ -1,5 +1,8 @@
 #include "WiFiProvisioner.h"
 
+// Tamanho máximo da senha do administrador (o main.cpp a lê num char[33])
+static const size_t ADMIN_PASSWORD_MAX = 32;
+
 // Definição da página HTML (static const)
 // ATUALIZADO com CSS e JavaScript para o relógio
 const char *WiFiProvisioner::_portal_html = R"EOF(
@@ -28,6 +31,12 @@ const char *WiFiProvisioner::_portal_html = R"EOF(
             <input type="text" id="ssid" name="ssid" required>
             <label for="pass">Senha:</label>
             <input type="password" id="pass" name="pass">
+            <label for="mqttHost">Broker MQTT (opcional):</label>
+            <input type="text" id="mqttHost" name="mqttHost" placeholder="192.168.0.10">
+            <label for="mqttPort">Porta do broker:</label>
+            <input type="number" id="mqttPort" name="mqttPort" placeholder="1883" min="1" max="65535">
+            <label for="senhaAdmin">Senha do administrador (atualiza&ccedil;&atilde;o de firmware):</label>
+            <input type="password" id="senhaAdmin" name="senhaAdmin" maxlength="32">
             <input type="submit" value="Salvar e Conectar">
         </form>
         
@@ -85,7 +94,7 @@ bool WiFiProvisioner::begin()
         // Se a conexão falhou, limpa as credenciais ruins
         if (_sta_ssid != "")
         {
-            Serial.println("Credenciais salvas falharam. Limpando.");
+            LOG_W("Credenciais salvas falharam. Limpando.\n");
             _preferences.begin("wifi-creds", false); // read-write
             _preferences.clear();
             _preferences.end();
@@ -96,7 +105,7 @@ bool WiFiProvisioner::begin()
         return false; // Não conectado
     }
 
-    Serial.println("Conexão Wi-Fi estabelecida.");
+    LOG_I("Conexão Wi-Fi estabelecida.\n");
     return true; // Conectado
 }
 
@@ -122,8 +131,11 @@ void WiFiProvisioner::loop()
             {
                 _reconnectTimer = millis(); // Reseta o timer
                 _connectAttempts++;
+                EventTracer::record(TRACE_WIFI_STATE,
+                                    _connectAttempts == 1 ? TRACE_WIFI_LOST : TRACE_WIFI_RECONNECTING,
+                                    WiFi.status());
 
-                Serial.printf("[WiFi] Conexão perdida. Tentando reconectar (Tentativa %d)...\n", _connectAttempts);
+                LOG_W("[WiFi] Conexão perdida. Tentando reconectar (Tentativa %d)...\n", _connectAttempts);
 
                 // Tenta reconectar de forma NÃO-BLOQUEANTE
                 WiFi.reconnect();
@@ -133,14 +145,14 @@ void WiFiProvisioner::loop()
                 // Reiniciamos para o modo AP.
                 if (_connectAttempts > 10)
                 {
-                    Serial.println("[WiFi] Muitas falhas. Reiniciando em modo AP.");
+                    LOG_W("[WiFi] Muitas falhas. Reiniciando em modo AP.\n");
 
                     // Limpa as credenciais ruins antes de reiniciar
                     _preferences.begin("wifi-creds", false);
                     _preferences.clear();
                     _preferences.end();
 
-                    delay(1000);   // Pausa para o Serial enviar a msg
+                    AsyncLog::flush(); // Espera o log sair pela serial
                     ESP.restart(); // O setup() tratará de iniciar o AP
                 }
             }
@@ -151,7 +163,8 @@ void WiFiProvisioner::loop()
             // Se vínhamos de uma tentativa de reconexão, regista o sucesso
             if (_connectAttempts > 0)
             {
-                Serial.println("[WiFi] Reconexão bem-sucedida!");
+                LOG_I("[WiFi] Reconexão bem-sucedida!\n");
+                EventTracer::record(TRACE_WIFI_STATE, TRACE_WIFI_CONNECTED, WiFi.status());
             }
             // Reseta o contador e o timer
             _connectAttempts = 0;
@@ -172,29 +185,30 @@ bool WiFiProvisioner::startSTAMode()
     if (_sta_ssid == "")
         return false;
 
-    Serial.printf("Tentando conectar a: %s\n", _sta_ssid.c_str());
+    LOG_I("Tentando conectar a: %s\n", _sta_ssid.c_str());
     WiFi.mode(WIFI_STA);
     WiFi.begin(_sta_ssid.c_str(), _sta_pass.c_str());
 
     int attempts = 0;
     while (WiFi.status() != WL_CONNECTED && attempts < 30)
     {
-        Serial.print(".");
+        LOG_I(".");
         delay(500);
         attempts++;
     }
 
     if (WiFi.status() == WL_CONNECTED)
     {
-        Serial.println("\n--- CONECTADO ---");
-        Serial.printf("IP: %s\n", WiFi.localIP().toString().c_str());
+        LOG_I("\n--- CONECTADO ---\n");
+        EventTracer::record(TRACE_WIFI_STATE, TRACE_WIFI_CONNECTED, WiFi.status());
+        LOG_I("IP: %s\n", WiFi.localIP().toString().c_str());
         _server.stop();
         _dnsServer.stop();
         return true;
     }
     else
     {
-        Serial.println("\nFalha ao conectar.");
+        LOG_W("\nFalha ao conectar.\n");
         WiFi.disconnect(true);
         return false;
     }
@@ -202,7 +216,8 @@ bool WiFiProvisioner::startSTAMode()
 
 void WiFiProvisioner::startAPMode()
 {
-    Serial.println("Iniciando Modo AP (Hotspot).");
+    LOG_I("Iniciando Modo AP (Hotspot).\n");
+    EventTracer::record(TRACE_WIFI_STATE, TRACE_WIFI_AP_MODE);
 
     WiFi.mode(WIFI_AP);
     WiFi.softAPConfig(_ap_ip, _ap_ip, IPAddress(255, 255, 255, 0));
@@ -210,8 +225,8 @@ void WiFiProvisioner::startAPMode()
 
     _dnsServer.start(53, "*", _ap_ip);
 
-    Serial.printf("AP SSID: %s\n", _ap_ssid.c_str());
-    Serial.printf("AP IP: %s\n", _ap_ip.toString().c_str());
+    LOG_I("AP SSID: %s\n", _ap_ssid.c_str());
+    LOG_I("AP IP: %s\n", _ap_ip.toString().c_str());
 
     // --- Rotas do Servidor Web ---
     // Usamos std::bind para ligar os métodos da classe aos callbacks
@@ -220,7 +235,7 @@ void WiFiProvisioner::startAPMode()
     _server.onNotFound(std::bind(&WiFiProvisioner::handleNotFound, this));
 
     _server.begin();
-    Serial.println("Servidor Web e DNS iniciados.");
+    LOG_I("Servidor Web e DNS iniciados.\n");
 }
 
 void WiFiProvisioner::handleRoot()
@@ -230,21 +245,68 @@ void WiFiProvisioner::handleRoot()
 
 void WiFiProvisioner::handleSave()
 {
-    Serial.println("Recebendo credenciais...");
+    LOG_I("Recebendo credenciais...\n");
+
+    // Confere tudo antes de gravar: um formulário inválido não muda nada na NVS
+    ArgView mqttPort = _server.argView("mqttPort");
+    long porta = 1883; // Em branco: porta padrão
+    if (mqttPort.valid() && mqttPort.data[0] != '\0')
+    {
+        char *end;
+        porta = strtol(mqttPort.data, &end, 10);
+        if (*end != '\0' || porta < 1 || porta > 65535)
+        {
+            _server.send(400, "text/html", "<html><body><h2>Porta do broker inv&aacute;lida</h2><p>Use um n&uacute;mero de 1 a 65535.</p></body></html>");
+            return;
+        }
+    }
 
-    _sta_ssid = _server.arg("ssid");
-    _sta_pass = _server.arg("pass");
+    // O main.cpp lê a senha num char[33]: mais longa, o OTA recusaria a senha digitada
+    ArgView senhaAdmin = _server.argView("senhaAdmin");
+    if (senhaAdmin.valid() && senhaAdmin.length > ADMIN_PASSWORD_MAX)
+    {
+        _server.send(400, "text/html", "<html><body><h2>Senha do administrador muito longa</h2><p>Use no m&aacute;ximo 32 caracteres.</p></body></html>");
+        return;
+    }
+
+    ArgView ssid = _server.argView("ssid");
+    ArgView pass = _server.argView("pass");
+    _sta_ssid = ssid.valid() ? ssid.data : "";
+    _sta_pass = pass.valid() ? pass.data : "";
 
     _preferences.begin("wifi-creds", false);
     _preferences.putString("ssid", _sta_ssid);
     _preferences.putString("pass", _sta_pass);
     _preferences.end();
 
-    String response = "<html><body><h2>Credenciais salvas!</h2><p>O ESP32 ir&aacute; reiniciar e tentar se conectar &agrave; rede <b>" + _sta_ssid + "</b>.</p></body></html>";
+    // Parâmetros de rede da aplicação: ficam fora de "wifi-creds", que é
+    // apagado quando a conexão falha
+    ArgView mqttHost = _server.argView("mqttHost");
+    Preferences rede;
+    rede.begin("rede", false);
+    rede.putString("mqttHost", mqttHost.valid() ? mqttHost.data : "");
+    rede.putUShort("mqttPort", (uint16_t)porta);
+    rede.end();
+
+    // Em branco mantém a senha atual (reconfigurar o Wi-Fi não desliga o OTA)
+    if (senhaAdmin.valid() && senhaAdmin.data[0] != '\0')
+    {
+        Preferences admin;
+        admin.begin("admin", false);
+        admin.putString("senha", senhaAdmin.data);
+        admin.end();
+    }
+
+    // Monta a resposta num buffer fixo (SSID tem no máximo 32 caracteres)
+    char response[256];
+    snprintf(response, sizeof(response),
+             "<html><body><h2>Credenciais salvas!</h2><p>O ESP32 ir&aacute; reiniciar e tentar se conectar &agrave; rede <b>%s</b>.</p></body></html>",
+             _sta_ssid.c_str());
     _server.send(200, "text/html", response);
 
-    Serial.println("Credenciais salvas. Reiniciando em 3 segundos...");
+    LOG_I("Credenciais salvas. Reiniciando em 3 segundos...\n");
     delay(3000);
+    AsyncLog::flush();
     ESP.restart();
 }
 
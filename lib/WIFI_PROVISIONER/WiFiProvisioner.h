@@ -6,6 +6,9 @@
 #include <WebServer.h>
 #include <DNSServer.h>
 #include <Preferences.h>
+#include "ArgWebServer.h"
+#include "EventTracer.h"
+#include "AsyncLog.h"
 #include <functional> // Necessário para std::bind
 
 class WiFiProvisioner
@@ -47,7 +50,7 @@ private:
     void handleNotFound();
 
     // --- Objetos de gerenciamento ---
-    WebServer _server;
+    ArgWebServer _server;
     DNSServer _dnsServer;
     Preferences _preferences;
 
@@ -0,0 +1,45 @@
+# Gera .pio/build/<env>/size_report.txt depois de cada build, com o uso
+# de flash e RAM do perfil de placa daquele ambiente.
+Import("env")
+
+import os
+import subprocess
+
+# Seções que ocupam flash e as que ocupam RAM estática (ESP32)
+FLASH_SECTIONS = (".flash.text", ".flash.rodata", ".flash.appdesc", ".iram0.vectors", ".iram0.text", ".dram0.data")
+RAM_SECTIONS = (".dram0.data", ".dram0.bss", ".iram0.vectors", ".iram0.text")
+
+
+def size_report(source, target, env):
+    elf = str(target[0])
+    output = subprocess.check_output([env.subst("$SIZETOOL"), "-A", "-d", elf]).decode()
+
+    sections = {}
+    for line in output.splitlines():
+        parts = line.split()
+        if len(parts) >= 2 and parts[0].startswith(".") and parts[1].isdigit():
+            sections[parts[0]] = int(parts[1])
+
+    flash = sum(sections.get(name, 0) for name in FLASH_SECTIONS)
+    ram = sum(sections.get(name, 0) for name in RAM_SECTIONS)
+    flags = " ".join(f for f in env.get("BUILD_FLAGS", []) if f.startswith("-DBOARD_PROFILE"))
+
+    lines = [
+        "env: %s" % env.subst("$PIOENV"),
+        "perfil: %s" % (flags or "(padrao)"),
+        "flash: %d bytes" % flash,
+        "ram estatica: %d bytes" % ram,
+        "",
+        "secao                bytes",
+    ]
+    for name in sorted(sections):
+        lines.append("%-20s %d" % (name, sections[name]))
+
+    report = os.path.join(env.subst("$BUILD_DIR"), "size_report.txt")
+    with open(report, "w") as f:
+        f.write("\n".join(lines) + "\n")
+
+    print("[size_report] %s: flash=%d ram=%d -> %s" % (env.subst("$PIOENV"), flash, ram, report))
+
+
+env.AddPostAction("$BUILD_DIR/${PROGNAME}.elf", size_report)
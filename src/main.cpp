@@ -1,11 +1,17 @@
 #include <Arduino.h>
+#include "BoardProfile.h"
 #include "WiFiProvisioner.h"
 #include "DashboardServer.h"
+#include "TelemetryPublisher.h"
+#include "EventTracer.h"
+#include "AsyncLog.h"
+#include "SensorHistory.h"
+#include "AdaptiveSampler.h"
+#include "TelemetryBeacon.h"
+#include "SecureDashboard.h"
 #include "time.h"
 #include <ArduinoJson.h>
 #include <Preferences.h>
-#include <Adafruit_Sensor.h> // <-- NOVO: Biblioteca DHT
-#include <DHT.h>             // <-- NOVO: Biblioteca DHT
 
 // TODO
 //  -> add grafhs for the month
@@ -17,53 +23,125 @@ WiFiProvisioner provisioner("ESP32-Config");
 DashboardServer dashboardServer(80);
 Preferences preferences;
 
+// Só existem se o perfil tiver a funcionalidade (BoardProfile.h)
+ProfileSlot<SecureDashboard, ActiveBoard::has(FEATURE_TLS)> secureDashboard(dashboardServer, 443); // Mesmas rotas por HTTPS
+ProfileSlot<TelemetryPublisher, ActiveBoard::has(FEATURE_TELEMETRY)> telemetry("ESP32-Luz");
+ProfileSlot<SensorHistory, ActiveBoard::has(FEATURE_HISTORY)> history; // Histórico de 32 dias para os gráficos
+ProfileSlot<TelemetryBeacon, ActiveBoard::has(FEATURE_BEACON)> beacon;
+
 // --- Configuração do NTP ---
 const char *ntpServer = "a.st1.ntp.br";
 const long gmtOffset_sec = -3 * 3600;
 const int daylightOffset_sec = 0;
 
+// --- Configuração da Telemetria (MQTT) ---
+// O broker é configurado no portal de Wi-Fi (NVS, namespace "rede")
+char mqttHost[64];
+uint16_t mqttPort;
+const char *mqttTopic = "pld/luz/telemetria";
+const unsigned long TELEMETRY_FLUSH_INTERVAL = 60000; // Envia um lote por minuto
+
+// --- Configuração do Beacon (UDP multicast na rede local) ---
+const IPAddress beaconGroup(239, 255, 42, 99);
+const uint16_t beaconPort = 5099;
+const unsigned long BEACON_INTERVAL = 10000; // E logo após cada mudança de estado
+
 // --- Configuração do PWM (LEDC) ---
-const int LEDC_PIN = 27;
-const int LEDC_CHANNEL = 0;
-const int LEDC_FREQ = 5000;
-const int LEDC_RESOLUTION = 8;
+// Pinos, frequência e resolução vêm do perfil da placa (BoardProfile.h)
+using Pwm = ActiveBoard::Pwm;
 const int RAMP_DURATION_MINUTES = 60;
 
 // --- Configuração dos Sensores ---
-#define DHTPIN 25
-#define DHTTYPE DHT11     // Mude para DHT11 se for o seu sensor
-#define LDR_PIN 35        // Pino do sensor de luminosidade
-DHT dht(DHTPIN, DHTTYPE); // Objeto do sensor DHT
+// Pinos e tipo do DHT também vêm do perfil. Sem o sensor, o driver é vazio.
+ActiveBoard::Dht::Driver dht = ActiveBoard::Dht::make(); // Objeto do sensor DHT
+
+// --- Amostragem Adaptativa ---
+// Lê rápido enquanto o sinal muda e recua até o máximo quando está estável.
+// O DHT11 não aceita leituras com menos de 2 s (a biblioteca devolve o valor antigo).
+// O LDR (analogRead, quase de graça) nunca passa dos 5 s da leitura fixa antiga:
+// persiana e lâmpada são degraus e precisam ser vistos logo.
+const unsigned long DHT_MIN_INTERVAL = 2000;
+const unsigned long DHT_MAX_INTERVAL = 60000;
+const unsigned long LDR_MIN_INTERVAL = 250;
+const unsigned long LDR_MAX_INTERVAL = 5000;
+AdaptiveSampler dhtSampler(DHT_MIN_INTERVAL, DHT_MAX_INTERVAL);
+AdaptiveSampler ldrSampler(LDR_MIN_INTERVAL, LDR_MAX_INTERVAL);
+// Limites: variação por segundo, desvio do ruído (resolução do DHT11 é 1 C / 1 %)
+// e janela da derivada (várias leituras no intervalo mínimo de cada sensor)
+ChangeDetector temperatureChange(0.02f, 0.6f, 30000);
+ChangeDetector humidityChange(0.1f, 1.5f, 30000);
+ChangeDetector luminosityChange(20.0f, 60.0f, 5000);
 // --- Variáveis de Controle ---
 bool ntpInitialized = false;
 unsigned long lastSerialPrint = 0;
 unsigned long lastPwmUpdate = 0;
-unsigned long lastSensorRead = 0; // <-- NOVO: Timer para sensores
+unsigned long lastTelemetrySample = 0;
 const unsigned long SERIAL_PRINT_INTERVAL = 10000;
-const unsigned long SENSOR_READ_INTERVAL = 5000; // Ler sensores a cada 5s
+const unsigned long TELEMETRY_SAMPLE_INTERVAL = 5000; // Amostra para o MQTT a cada 5s
 int currentPwm = 0;
 
 // =========================================================
 // --- DADOS DO SEU PROJETO (SENSORES E ESTADO) ---
 // Sensores (agora com valores reais)
-float currentTemperature = 0.0;
-float currentHumidity = 0.0;
+float currentTemperature = NAN; // NAN até a primeira leitura boa (ou sem sensor)
+float currentHumidity = NAN;
 int currentLuminosity = 0; // Valor 0-4095
 // Configurações
-String horaLigar;
-String horaDesligar;
+char horaLigar[6];    // "HH:MM"
+char horaDesligar[6]; // "HH:MM"
 int luzMaximaSalva;
 // =========================================================
 
+/**
+ * @brief Avisa a telemetria (MQTT e beacon) de uma mudança de estado.
+ */
+void notificarTelemetria()
+{
+  if constexpr (ActiveBoard::has(FEATURE_TELEMETRY))
+  {
+    telemetry->notifyStateChange();
+  }
+  if constexpr (ActiveBoard::has(FEATURE_BEACON))
+  {
+    beacon->notifyChange();
+  }
+}
+
+/**
+ * @brief Guarda uma leitura do DHT no histórico (se o perfil tiver histórico).
+ * Cada sensor tem a sua série: o LDR é lido bem mais vezes que o DHT.
+ */
+void registrarClima(float temperatura, float humidade)
+{
+  if constexpr (ActiveBoard::has(FEATURE_HISTORY))
+  {
+    history->appendClimate(time(nullptr), temperatura, humidade);
+  }
+}
+
+/**
+ * @brief Guarda uma leitura do LDR no histórico (se o perfil tiver histórico).
+ */
+void registrarLuz(int luminosidade)
+{
+  if constexpr (ActiveBoard::has(FEATURE_HISTORY))
+  {
+    history->appendLight(time(nullptr), luminosidade);
+  }
+}
+
 /**
  * @brief Converte "HH:MM" para minutos.
  */
-int parseTimeMinutes(String hh_mm)
+int parseTimeMinutes(const char *hh_mm)
 {
-  if (hh_mm.length() != 5)
+  if (hh_mm == nullptr || strlen(hh_mm) != 5)
+    return 0;
+  // Lê os dígitos direto, sem criar Strings temporárias
+  int hour = (hh_mm[0] - '0') * 10 + (hh_mm[1] - '0');
+  int minute = (hh_mm[3] - '0') * 10 + (hh_mm[4] - '0');
+  if (hour < 0 || hour > 23 || minute < 0 || minute > 59)
     return 0;
-  int hour = hh_mm.substring(0, 2).toInt();
-  int minute = hh_mm.substring(3, 5).toInt();
   return (hour * 60) + minute;
 }
 
@@ -83,8 +161,7 @@ void updateLightPwm()
   int desligarMinutes = parseTimeMinutes(horaDesligar);
   int rampStartMinutes = ligarMinutes - RAMP_DURATION_MINUTES;
   int fadeStartMinutes = desligarMinutes - RAMP_DURATION_MINUTES;
-  float maxPwmFloat = (float)luzMaximaSalva * 2.55;
-  int maxPwm = (int)min(maxPwmFloat, 255.0f);
+  int maxPwm = (int)min((long)luzMaximaSalva * Pwm::maxDuty / 100, (long)Pwm::maxDuty);
   int newPwm = 0;
   bool overnight = (desligarMinutes < ligarMinutes);
 
@@ -130,44 +207,123 @@ void updateLightPwm()
   if (newPwm != currentPwm)
   {
     currentPwm = newPwm;
-    ledcWrite(LEDC_CHANNEL, currentPwm);
+    for (uint8_t channel = 0; channel < Pwm::channels; channel++)
+    {
+      ledcWrite(channel, currentPwm);
+    }
+    EventTracer::record(TRACE_PWM_CHANGE, 0, currentPwm);
+    notificarTelemetria();
   }
 }
 
 /**
- * @brief NOVO: Função para ler os sensores de hardware.
- * É chamada pelo timer no loop().
+ * @brief Lê o DHT (temperatura e humidade) e agenda a próxima leitura.
+ * É chamada pelo loop() quando o dhtSampler indica.
  */
-void atualizarSensoresReais()
+void atualizarDHT()
 {
-  // 1. Leitura do DHT22
+  unsigned long now = millis();
+  unsigned long dt = dhtSampler.elapsed(now);
+  bool active = false;
+
   // A leitura pode falhar. Se falhar (isNaN), mantém o último valor bom.
+  // Falha não conta como mudança: um DHT solto ou queimado recua até o
+  // intervalo máximo em vez de ser lido (e logado) a cada 2 s.
   float newTemp = dht.readTemperature();
   if (!isnan(newTemp))
   {
     currentTemperature = newTemp;
+    active |= temperatureChange.update(newTemp, dt);
+    EventTracer::record(TRACE_SENSOR_READ, TRACE_SENSOR_TEMPERATURE, (int32_t)(newTemp * 10));
   }
   else
   {
-    Serial.println("[Sensor] Falha ao ler temperatura do DHT!");
+    EventTracer::record(TRACE_SENSOR_FAIL, TRACE_SENSOR_TEMPERATURE);
   }
 
   float newHum = dht.readHumidity();
   if (!isnan(newHum))
   {
     currentHumidity = newHum;
+    active |= humidityChange.update(newHum, dt);
+    EventTracer::record(TRACE_SENSOR_READ, TRACE_SENSOR_HUMIDITY, (int32_t)(newHum * 10));
   }
   else
   {
-    Serial.println("[Sensor] Falha ao ler humidade do DHT!");
+    EventTracer::record(TRACE_SENSOR_FAIL, TRACE_SENSOR_HUMIDITY);
+  }
+
+  // O log só marca o começo e o fim da falha (o trace guarda cada uma)
+  static bool dhtFailing = false;
+  bool failing = isnan(newTemp) || isnan(newHum);
+  if (failing && !dhtFailing)
+  {
+    LOG_W("[Sensor] Falha ao ler o DHT (temperatura:%s, humidade:%s). Recuando as leituras.\n",
+          isnan(newTemp) ? "falhou" : "ok", isnan(newHum) ? "falhou" : "ok");
+  }
+  else if (!failing && dhtFailing)
+  {
+    LOG_I("[Sensor] DHT voltou a responder.\n");
   }
+  dhtFailing = failing;
+
+  dhtSampler.schedule(active, now);
+  registrarClima(newTemp, newHum); // Leitura que falhou (NAN) não entra
+
+  // Só é compilado com -DLOG_LEVEL=LOG_LEVEL_DEBUG
+  LOG_D("[Sensor] T:%.1f C, H:%.1f %%, proxima em %lu ms\n",
+        currentTemperature, currentHumidity, dhtSampler.interval());
+}
+
+/**
+ * @brief Lê o sensor de luminosidade (LDR) e agenda a próxima leitura.
+ */
+void atualizarLDR()
+{
+  unsigned long now = millis();
 
-  // 2. Leitura do Sensor de Luminosidade (LDR)
   // O ADC de 12 bits do ESP32 retorna valores de 0 (0V) a 4095 (3.3V)
-  currentLuminosity = analogRead(LDR_PIN);
+  currentLuminosity = analogRead(ActiveBoard::Ldr::pin);
+  EventTracer::record(TRACE_SENSOR_READ, TRACE_SENSOR_LUMINOSITY, currentLuminosity);
 
-  // Descomente para debug
-  // Serial.printf("[Sensor] T:%.1f C, H:%.1f %%, L:%d\n", currentTemperature, currentHumidity, currentLuminosity);
+  ldrSampler.schedule(luminosityChange.update(currentLuminosity, ldrSampler.elapsed(now)), now);
+  registrarLuz(currentLuminosity);
+
+  LOG_D("[Sensor] L:%d, proxima em %lu ms\n", currentLuminosity, ldrSampler.interval());
+}
+
+/**
+ * @brief Preenche o modelo de dados do dispositivo.
+ * Usado tanto pelo /data.json quanto pela telemetria MQTT.
+ */
+void preencherDados(JsonDocument &doc)
+{
+  // NÃO lemos sensores aqui. Apenas reportamos os valores
+  // que foram lidos pelo timer no loop() principal.
+
+  // Sensor ausente no perfil, ou ainda sem leitura: null, e não um 0 que
+  // pareça medido
+  if (!isnan(currentTemperature))
+    doc["temperatura"] = currentTemperature;
+  else
+    doc["temperatura"] = nullptr;
+  if (!isnan(currentHumidity))
+    doc["humidade"] = currentHumidity;
+  else
+    doc["humidade"] = nullptr;
+  if constexpr (ActiveBoard::Ldr::present)
+    doc["luminosidade"] = currentLuminosity; // Envia o valor 0-4095
+  else
+    doc["luminosidade"] = nullptr;
+
+  doc["hora_ligar"] = horaLigar;
+  doc["hora_desligar"] = horaDesligar;
+  doc["luz_maxima"] = luzMaximaSalva;
+  doc["pwm"] = currentPwm;
+
+  // Intervalo atual da amostragem adaptativa (ms)
+  doc["intervalo_dht"] = dhtSampler.interval();
+  doc["intervalo_ldr"] = ldrSampler.interval();
 }
 
 // =================================================================
@@ -176,61 +332,114 @@ void atualizarSensoresReais()
 
 void initNTP()
 {
-  Serial.println("Configurando NTP...");
+  LOG_I("Configurando NTP...\n");
   configTime(gmtOffset_sec, daylightOffset_sec, ntpServer);
-  Serial.println("Sincronizando hora...");
+  LOG_I("Sincronizando hora...\n");
 }
 
 void printSerialStatus()
 {
   struct tm timeinfo;
-  Serial.println("---------------------------------");
-  Serial.println("Status: Conectado");
-  Serial.printf("  IP: %s\n", WiFi.localIP().toString().c_str()); // Corrigido de .c.str()
+  LOG_I("---------------------------------\n");
+  LOG_I("Status: Conectado\n");
+  LOG_I("  IP: %s\n", WiFi.localIP().toString().c_str()); // Corrigido de .c.str()
 
   if (getLocalTime(&timeinfo, 100))
   {
     if (!ntpInitialized)
+    {
       ntpInitialized = true;
+      EventTracer::record(TRACE_NTP_SYNC, 0, timeinfo.tm_hour * 60 + timeinfo.tm_min);
+    }
     char buffer[80];
     strftime(buffer, sizeof(buffer), "%A, %d/%m/%Y %H:%M:%S", &timeinfo);
-    Serial.printf("  Hora: %s\n", buffer);
+    LOG_I("  Hora: %s\n", buffer);
   }
   else
   {
-    Serial.println("  Hora: ...aguardando sincronia NTP...");
+    LOG_I("  Hora: ...aguardando sincronia NTP...\n");
   }
 
   // ATUALIZADO: Mostra os valores reais (raw para LDR)
-  Serial.printf("  Sensores: Temp=%.1f C, Hum=%.1f %%, Lum=%d (raw)\n",
-                currentTemperature, currentHumidity, currentLuminosity);
-  Serial.printf("  Config: Luz Ligar=%s, Desligar=%s, Max=%d%% (PWM: %d/255)\n",
-                horaLigar.c_str(), horaDesligar.c_str(), luzMaximaSalva, currentPwm);
+  LOG_I("  Sensores: Temp=%.1f C, Hum=%.1f %%, Lum=%d (raw)\n",
+        currentTemperature, currentHumidity, currentLuminosity);
+  LOG_I("  Config: Luz Ligar=%s, Desligar=%s, Max=%d%% (PWM: %d/%d)\n",
+        horaLigar, horaDesligar, luzMaximaSalva, currentPwm, Pwm::maxDuty);
+
+  // Fragmentação: se o maior bloco livre cai com o tempo e o livre não, o heap está picotado
+  LOG_I("  Heap: livre=%u, maior bloco=%u, minimo=%u; arena HTTP pico=%u/%u\n",
+        (unsigned)ESP.getFreeHeap(), (unsigned)ESP.getMaxAllocHeap(), (unsigned)ESP.getMinFreeHeap(),
+        (unsigned)dashboardServer.arenaPeak(), (unsigned)DashboardServer::arenaSize());
+
+  // Mensagens perdidas com o buffer do log cheio (desde o boot)
+  LOG_I("  Log: %u mensagens descartadas\n", (unsigned)AsyncLog::dropped());
 }
 
 void setup()
 {
   Serial.begin(115200);
-  Serial.println("\n\nIniciando...");
+  AsyncLog::begin(); // A partir daqui o log não bloqueia o loop()
+  LOG_I("\n\nIniciando...\n");
+  if constexpr (ActiveBoard::has(FEATURE_TRACE))
+  {
+    LOG_I("[Trace] Custo por evento: %u ciclos\n", (unsigned)EventTracer::benchmarkCycles());
+  }
 
   // *** NVS ***
   preferences.begin("app-settings", false);
-  horaLigar = preferences.getString("horaLigar", "08:00");
-  horaDesligar = preferences.getString("horaDesligar", "18:00");
+  strcpy(horaLigar, "08:00"); // Valores padrão, se não houver nada salvo
+  strcpy(horaDesligar, "18:00");
+  preferences.getString("horaLigar", horaLigar, sizeof(horaLigar));
+  preferences.getString("horaDesligar", horaDesligar, sizeof(horaDesligar));
   luzMaximaSalva = preferences.getInt("luzMaxima", 80);
   preferences.end();
-  Serial.println("Configurações carregadas da NVS.");
+
+  preferences.begin("rede", true);
+  mqttHost[0] = '\0';
+  preferences.getString("mqttHost", mqttHost, sizeof(mqttHost));
+  mqttPort = preferences.getUShort("mqttPort", 1883);
+  preferences.end();
+
+  // Senha do /update (definida no portal de Wi-Fi). Sem ela o OTA fica desligado.
+  char senhaAdmin[33] = "";
+  preferences.begin("admin", true);
+  preferences.getString("senha", senhaAdmin, sizeof(senhaAdmin));
+  preferences.end();
+  dashboardServer.setAdminPassword(senhaAdmin);
+
+  // Mesmo id do beacon no /data.json: o coletor junta as duas fontes na mesma série
+  char deviceId[9];
+  snprintf(deviceId, sizeof(deviceId), "%08x", (unsigned)TelemetryBeacon::deviceId());
+  dashboardServer.setDeviceId(deviceId);
+  LOG_I("Configurações carregadas da NVS.\n");
 
   // *** INICIALIZAÇÃO DOS SENSORES REAIS ***
-  Serial.println("Iniciando sensores...");
-  dht.begin(); // Inicializa o DHT
-  // O analogRead (pino 34) não precisa de pinMode, mas é bom configurar
-  pinMode(LDR_PIN, INPUT);
+  LOG_I("Iniciando sensores...\n");
+  if constexpr (ActiveBoard::Dht::present)
+  {
+    dht.begin(); // Inicializa o DHT
+  }
+  if constexpr (ActiveBoard::Ldr::present)
+  {
+    // O analogRead não precisa de pinMode, mas é bom configurar
+    pinMode(ActiveBoard::Ldr::pin, INPUT);
+  }
+  if constexpr (ActiveBoard::has(FEATURE_HISTORY))
+  {
+    if (!history->begin())
+    {
+      LOG_E("[Historico] Sem memoria para o historico dos sensores.\n");
+    }
+  }
 
   // *** PWM (LEDC) ***
-  ledcSetup(LEDC_CHANNEL, LEDC_FREQ, LEDC_RESOLUTION);
-  ledcAttachPin(LEDC_PIN, LEDC_CHANNEL);
-  ledcWrite(LEDC_CHANNEL, 0);
+  // Um canal LEDC por pino do perfil
+  for (uint8_t channel = 0; channel < Pwm::channels; channel++)
+  {
+    ledcSetup(channel, Pwm::frequency, Pwm::resolution);
+    ledcAttachPin(Pwm::pins[channel], channel);
+    ledcWrite(channel, 0);
+  }
   currentPwm = 0;
 
   if (provisioner.begin())
@@ -239,26 +448,14 @@ void setup()
     initNTP();
 
     // CALLBACK 1: O que o ESP32 ENVIA para a web (GET)
-    dashboardServer.onDataRequest([](JsonDocument &doc)
-                                  {
-            
-            // NÃO lemos sensores aqui. Apenas reportamos os valores
-            // que foram lidos pelo timer no loop() principal.
-            
-            doc["temperatura"] = currentTemperature;
-            doc["humidade"] = currentHumidity;
-            doc["luminosidade"] = currentLuminosity; // Envia o valor 0-4095
-            
-            doc["hora_ligar"] = horaLigar;       
-            doc["hora_desligar"] = horaDesligar; 
-            doc["luz_maxima"] = luzMaximaSalva; });
+    dashboardServer.onDataRequest(preencherDados);
 
     // CALLBACK 2: O que o ESP32 RECEBE da web (POST)
-    dashboardServer.onSettingsRequest([](String ligar, String desligar, int luzMaxima)
+    dashboardServer.onSettingsRequest([](const char *ligar, const char *desligar, int luzMaxima)
                                       {
             
-            horaLigar = ligar;
-            horaDesligar = desligar;
+            strlcpy(horaLigar, ligar, sizeof(horaLigar));
+            strlcpy(horaDesligar, desligar, sizeof(horaDesligar));
             luzMaximaSalva = luzMaxima;
 
             preferences.begin("app-settings", false); 
@@ -267,19 +464,58 @@ void setup()
             preferences.putInt("luzMaxima", luzMaximaSalva);
             preferences.end(); 
 
-            Serial.println("\n!!! NOVAS CONFIGURAÇÕES SALVAS NA NVS !!!");
-            Serial.printf("Ligar às: %s\n", horaLigar.c_str());
-            Serial.printf("Desligar às: %s\n", horaDesligar.c_str());
-            Serial.printf("Luz Máxima: %d%%\n\n", luzMaximaSalva); });
+            LOG_I("\n!!! NOVAS CONFIGURAÇÕES SALVAS NA NVS !!!\n");
+            LOG_I("Ligar às: %s\n", horaLigar);
+            LOG_I("Desligar às: %s\n", horaDesligar);
+            LOG_I("Luz Máxima: %d%%\n\n", luzMaximaSalva);
 
+            notificarTelemetria(); });
+
+    // CALLBACK 3: Histórico para os gráficos (GET /history.json)
+    if constexpr (ActiveBoard::has(FEATURE_HISTORY))
+    {
+      dashboardServer.onHistoryRequest([](Print &out, time_t from, time_t to, uint32_t step)
+                                       { history->writeJson(out, from, to, step); });
+    }
+
+    // O HTTPS sobe antes: com ele no ar, a porta 80 só redireciona a página
+    // e não aceita /settings nem /update
+    bool httpsUp = false;
+    if constexpr (ActiveBoard::has(FEATURE_TLS))
+    {
+      httpsUp = secureDashboard->begin(); // Só sobe se houver certificado no NVS
+      if (httpsUp)
+        dashboardServer.redirectToHttps(443);
+    }
     dashboardServer.begin();
-    Serial.print("Acesse o dashboard em: http://");
-    Serial.println(WiFi.localIP());
+
+    // Telemetria: mesmo modelo de dados, enviado em lotes para o broker
+    if constexpr (ActiveBoard::has(FEATURE_TELEMETRY))
+    {
+      if (mqttHost[0] != '\0')
+      {
+        telemetry->onDataRequest(preencherDados);
+        telemetry->begin(mqttHost, mqttPort, mqttTopic, TELEMETRY_FLUSH_INTERVAL);
+      }
+      else
+      {
+        LOG_W("[MQTT] Broker não configurado no portal. Telemetria desativada.\n");
+      }
+    }
+    if constexpr (ActiveBoard::has(FEATURE_BEACON))
+    {
+      beacon->onDataRequest(preencherDados);
+      beacon->begin(beaconGroup, beaconPort, BEACON_INTERVAL);
+    }
+
+    LOG_I("Acesse o dashboard em: %s://%s\n", httpsUp ? "https" : "http", WiFi.localIP().toString().c_str());
   }
   else
   {
-    Serial.println("Iniciado em modo AP para configuração.");
+    LOG_I("Iniciado em modo AP para configuração.\n");
   }
+
+  LOG_I("[Boot] setup() concluido em %lu ms\n", millis());
 }
 
 void loop()
@@ -289,6 +525,10 @@ void loop()
   if (provisioner.isConnected())
   {
     dashboardServer.loop(); // Processa clientes web
+    if constexpr (ActiveBoard::has(FEATURE_TLS))
+    {
+      secureDashboard->loop(); // Pedidos do HTTPS que usam o estado do sketch
+    }
 
     // --- LÓGICA DA LUZ ---
     if (ntpInitialized && (millis() - lastPwmUpdate > 1000))
@@ -297,14 +537,6 @@ void loop()
       updateLightPwm(); // Chama a função de lógica da rampa
     }
 
-    // --- LÓGICA DE LEITURA DE SENSORES ---
-    // Lê os sensores de hardware em um intervalo separado
-    if (millis() - lastSensorRead > SENSOR_READ_INTERVAL)
-    {
-      lastSensorRead = millis();
-      atualizarSensoresReais(); // Chama a nova função de leitura
-    }
-
     // --- LÓGICA DE IMPRESSÃO SERIAL ---
     if (millis() - lastSerialPrint > SERIAL_PRINT_INTERVAL)
     {
@@ -313,5 +545,39 @@ void loop()
     }
   }
 
+  // --- LÓGICA DE LEITURA DE SENSORES ---
+  // Cada sensor tem o seu intervalo, ajustado pela amostragem adaptativa.
+  // Continua mesmo sem Wi-Fi: as amostras ficam na fila da telemetria.
+  if constexpr (ActiveBoard::Dht::present)
+  {
+    if (dhtSampler.due(millis()))
+    {
+      atualizarDHT();
+    }
+  }
+  if constexpr (ActiveBoard::Ldr::present)
+  {
+    if (ldrSampler.due(millis()))
+    {
+      atualizarLDR();
+    }
+  }
+
+  // --- TELEMETRIA (MQTT) ---
+  // Envia os lotes ou os guarda na flash se o broker/Wi-Fi estiver fora
+  if constexpr (ActiveBoard::has(FEATURE_TELEMETRY))
+  {
+    if (millis() - lastTelemetrySample > TELEMETRY_SAMPLE_INTERVAL)
+    {
+      lastTelemetrySample = millis();
+      telemetry->sample();
+    }
+    telemetry->loop(provisioner.isConnected());
+  }
+  if constexpr (ActiveBoard::has(FEATURE_BEACON))
+  {
+    beacon->loop(provisioner.isConnected());
+  }
+
   delay(10); // Pequeno delay para estabilidade
 }
\ No newline at end of file
@@ -0,0 +1,404 @@
+// Replay de sinais de sensor no AdaptiveSampler, no PC: pio test -e native
+//
+// Os sinais são gerados com ruído e quantização parecidos com os do LDR
+// (ADC de 12 bits) e do DHT11 (1 C), e lidos como o loop() do main.cpp lê:
+// só quando o sampler está na hora. Confere que ruído sozinho deixa o
+// sensor recuar até o intervalo máximo e que uma mudança real o traz de
+// volta ao mínimo.
+//
+// A última parte compara com a leitura fixa a cada 5 s (o código antigo):
+// quantas leituras a amostragem adaptativa economiza e quanto erra o valor
+// mostrado (a última leitura, mantida até a próxima) em relação ao sinal real.
+
+#include <unity.h>
+
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <random>
+
+#include "AdaptiveSampler.h"
+
+// Mesmos valores do main.cpp
+static const unsigned long DHT_MIN_INTERVAL = 2000;
+static const unsigned long DHT_MAX_INTERVAL = 60000;
+static const unsigned long LDR_MIN_INTERVAL = 250;
+static const unsigned long LDR_MAX_INTERVAL = 5000;
+
+static const unsigned long BASELINE_INTERVAL = 5000;
+
+struct Replay
+{
+    unsigned long reads = 0;
+    unsigned long readsAtMin = 0;
+    unsigned long lastInterval = 0;
+    unsigned long firstAtMin = 0; // Hora da primeira leitura no intervalo mínimo (0 = nenhuma)
+};
+
+// Roda o sinal de 'start' até 'end' (ms), lendo quando o sampler manda
+static Replay replay(AdaptiveSampler &sampler, ChangeDetector &detector, unsigned long start, unsigned long end,
+                     unsigned long minInterval, const std::function<float(unsigned long)> &signal)
+{
+    Replay result;
+    for (unsigned long now = start; now < end; now += 10)
+    {
+        if (!sampler.due(now))
+            continue;
+        bool active = detector.update(signal(now), sampler.elapsed(now));
+        sampler.schedule(active, now);
+        result.reads++;
+        if (sampler.interval() == minInterval)
+        {
+            if (result.readsAtMin == 0)
+                result.firstAtMin = now;
+            result.readsAtMin++;
+        }
+        result.lastInterval = sampler.interval();
+    }
+    return result;
+}
+
+void setUp() {}
+void tearDown() {}
+
+// Antes a derivada era dividida pelo intervalo entre leituras: a 250 ms o
+// ruído do ADC já passava do limite e o LDR ficava preso no mínimo
+void test_ldr_noise_backs_off()
+{
+    std::mt19937 rng(1);
+    std::normal_distribution<float> noise(0.0f, 25.0f);
+    auto ldr = [&](unsigned long) { return std::round(2000.0f + noise(rng)); };
+
+    AdaptiveSampler sampler(LDR_MIN_INTERVAL, LDR_MAX_INTERVAL);
+    ChangeDetector detector(20.0f, 60.0f, 5000);
+
+    replay(sampler, detector, 0, 10 * 60000UL, LDR_MIN_INTERVAL, ldr);
+    TEST_ASSERT_EQUAL(LDR_MAX_INTERVAL, sampler.interval());
+
+    // Em regime: uma hora de ruído, quase tudo no intervalo máximo
+    Replay steady = replay(sampler, detector, 10 * 60000UL, 70 * 60000UL, LDR_MIN_INTERVAL, ldr);
+    TEST_ASSERT_TRUE(steady.reads < 3600000UL / LDR_MAX_INTERVAL + 20);
+}
+
+// Os mesmos dados de ruído, lidos a 250 ms ou a 2 s, dão a mesma decisão
+void test_decision_does_not_depend_on_read_rate()
+{
+    const unsigned long rates[] = {250, 1000, 2000};
+    for (unsigned long dt : rates)
+    {
+        std::mt19937 rng(2);
+        std::normal_distribution<float> noise(0.0f, 25.0f);
+        ChangeDetector detector(20.0f, 60.0f, 5000);
+
+        unsigned long active = 0;
+        unsigned long reads = 0;
+        for (unsigned long t = 0; t < 600000UL; t += dt)
+        {
+            bool changing = detector.update(2000.0f + noise(rng), dt);
+            if (t >= 60000UL)
+            {
+                reads++;
+                active += changing;
+            }
+        }
+        char message[64];
+        snprintf(message, sizeof(message), "Leitura a cada %lu ms: %lu/%lu ativas", dt, active, reads);
+        TEST_ASSERT_TRUE_MESSAGE(active * 100 < reads, message);
+    }
+}
+
+// Persiana abrindo: degrau de 1500 no LDR é visto na primeira leitura
+void test_ldr_step_returns_to_min()
+{
+    std::mt19937 rng(3);
+    std::normal_distribution<float> noise(0.0f, 25.0f);
+    const unsigned long stepAt = 20 * 60000UL;
+    auto ldr = [&](unsigned long now) { return std::round((now < stepAt ? 2000.0f : 3500.0f) + noise(rng)); };
+
+    AdaptiveSampler sampler(LDR_MIN_INTERVAL, LDR_MAX_INTERVAL);
+    ChangeDetector detector(20.0f, 60.0f, 5000);
+
+    replay(sampler, detector, 0, stepAt, LDR_MIN_INTERVAL, ldr);
+    TEST_ASSERT_EQUAL(LDR_MAX_INTERVAL, sampler.interval());
+
+    // A primeira leitura depois do degrau (no máximo LDR_MAX_INTERVAL
+    // depois, como a leitura fixa antiga de 5 s) já volta ao mínimo...
+    Replay after = replay(sampler, detector, stepAt, stepAt + 60000UL, LDR_MIN_INTERVAL, ldr);
+    TEST_ASSERT_TRUE(after.readsAtMin > 0);
+    TEST_ASSERT_TRUE(after.firstAtMin - stepAt <= LDR_MAX_INTERVAL);
+
+    // ...e depois que o sinal assenta, recua de novo
+    replay(sampler, detector, stepAt + 60000UL, stepAt + 10 * 60000UL, LDR_MIN_INTERVAL, ldr);
+    TEST_ASSERT_EQUAL(LDR_MAX_INTERVAL, sampler.interval());
+}
+
+// DHT11: valor inteiro oscilando entre 22 e 23 C não é mudança
+void test_dht_quantisation_flicker_backs_off()
+{
+    std::mt19937 rng(4);
+    std::normal_distribution<float> noise(0.0f, 0.3f);
+    auto dht = [&](unsigned long) { return std::round(22.5f + noise(rng)); };
+
+    AdaptiveSampler sampler(DHT_MIN_INTERVAL, DHT_MAX_INTERVAL);
+    ChangeDetector detector(0.02f, 0.6f, 30000);
+
+    Replay warmup = replay(sampler, detector, 0, 30 * 60000UL, DHT_MIN_INTERVAL, dht);
+    Replay steady = replay(sampler, detector, 30 * 60000UL, 90 * 60000UL, DHT_MIN_INTERVAL, dht);
+    TEST_ASSERT_TRUE(warmup.reads > 0);
+    TEST_ASSERT_TRUE(steady.reads < 3600000UL / DHT_MAX_INTERVAL + 20);
+    TEST_ASSERT_EQUAL(DHT_MAX_INTERVAL, steady.lastInterval);
+}
+
+// Aquecedor ligado: 3 C em 2 minutos é mudança, mesmo quantizado
+void test_dht_ramp_is_detected()
+{
+    std::mt19937 rng(5);
+    std::normal_distribution<float> noise(0.0f, 0.3f);
+    const unsigned long rampAt = 30 * 60000UL;
+    const unsigned long rampEnd = rampAt + 2 * 60000UL;
+    auto dht = [&](unsigned long now)
+    {
+        float base = 22.0f;
+        if (now >= rampEnd)
+            base = 25.0f;
+        else if (now >= rampAt)
+            base = 22.0f + 3.0f * (now - rampAt) / (rampEnd - rampAt);
+        return std::round(base + noise(rng));
+    };
+
+    AdaptiveSampler sampler(DHT_MIN_INTERVAL, DHT_MAX_INTERVAL);
+    ChangeDetector detector(0.02f, 0.6f, 30000);
+
+    replay(sampler, detector, 0, rampAt, DHT_MIN_INTERVAL, dht);
+    TEST_ASSERT_EQUAL(DHT_MAX_INTERVAL, sampler.interval());
+
+    Replay ramp = replay(sampler, detector, rampAt, rampEnd + DHT_MAX_INTERVAL, DHT_MIN_INTERVAL, dht);
+    TEST_ASSERT_TRUE(ramp.readsAtMin > 0);
+}
+
+// Perto do limite a decisão não pode alternar a cada janela
+void test_hysteresis_holds_near_threshold()
+{
+    ChangeDetector detector(20.0f, 1000.0f, 5000);
+
+    // Rampa de 30/s: em mudança
+    float value = 0;
+    bool changing = false;
+    for (int i = 0; i < 40; i++)
+    {
+        value += 30.0f * 0.25f;
+        changing = detector.update(value, 250);
+    }
+    TEST_ASSERT_TRUE(changing);
+
+    // 16/s: abaixo do limite de entrada, acima do de saída (20 x 0,7 = 14)
+    for (int i = 0; i < 200; i++)
+    {
+        value += 16.0f * 0.25f;
+        TEST_ASSERT_TRUE(detector.update(value, 250));
+    }
+
+    // 10/s: abaixo dos dois, volta a estável
+    for (int i = 0; i < 40; i++)
+    {
+        value += 10.0f * 0.25f;
+        changing = detector.update(value, 250);
+    }
+    TEST_ASSERT_FALSE(changing);
+}
+
+// --- Leituras economizadas x erro de reconstrução ---
+
+// Um dia sintético (ms -> valor real, sem ruído)
+static const unsigned long DAY = 24 * 3600000UL;
+
+static float hourOf(unsigned long t) { return (float)t / 3600000.0f; }
+
+// Ramp de 0 a 1 entre 'from' e 'to' horas
+static float ramp(float h, float from, float to)
+{
+    return h <= from ? 0.0f : h >= to ? 1.0f : (h - from) / (to - from);
+}
+
+// LDR: noite, nascer do sol, nuvens, persiana abrindo às 9 h, lâmpada das 19 h às 23 h.
+// Os degraus caem fora da grade de 5 s da leitura fixa, como na vida real.
+static float ldrTruth(unsigned long t)
+{
+    float h = hourOf(t);
+    float sun = ramp(h, 6.0f, 8.0f) * (1.0f - ramp(h, 18.0f, 20.0f));
+    float clouds = 300.0f * sinf(h * 6.2832f * 3.0f); // Período de 20 min
+    float blind = t >= 9 * 3600000UL + 2700 ? 1000.0f : 0.0f;
+    float lamp = t >= 19 * 3600000UL + 1300 && t < 23 * 3600000UL + 3900 ? 1500.0f : 0.0f;
+    return 100.0f + sun * (1900.0f + clouds + blind) + lamp;
+}
+
+// Temperatura: ciclo diário e aquecedor ligado às 7 h (+3 C em 10 min, cai em 2 h)
+static float temperatureTruth(unsigned long t)
+{
+    float h = hourOf(t);
+    float heater = 3.0f * (ramp(h, 7.0f, 7.167f) - ramp(h, 7.167f, 9.167f));
+    return 21.0f + 3.0f * sinf((h - 9.0f) / 24.0f * 6.2832f) + heater;
+}
+
+// Humidade: ciclo diário e banho às 20 h (+25 % em 5 min, cai em 30 min)
+static float humidityTruth(unsigned long t)
+{
+    float h = hourOf(t);
+    float shower = 25.0f * (ramp(h, 20.0f, 20.083f) - ramp(h, 20.083f, 20.583f));
+    return 55.0f - 10.0f * sinf((h - 9.0f) / 24.0f * 6.2832f) + shower;
+}
+
+// O erro só conta depois do aquecimento (primeiras leituras e filtros)
+static const unsigned long WARMUP = 10 * 60000UL;
+
+struct Reconstruction
+{
+    unsigned long reads = 0;
+    double sumSquares = 0;
+    double maxError = 0;
+    unsigned long samples = 0;
+
+    double rms() const { return samples ? std::sqrt(sumSquares / samples) : 0; }
+
+    void measure(float shown, float truth)
+    {
+        double error = std::fabs((double)shown - truth);
+        sumSquares += error * error;
+        if (error > maxError)
+            maxError = error;
+        samples++;
+    }
+};
+
+// Lê o LDR como o loop() (adaptativo, ou fixo se sampler == nullptr) e
+// compara o valor mostrado com o real a cada 100 ms
+static Reconstruction reconstructLdr(AdaptiveSampler *sampler, uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    std::normal_distribution<float> noise(0.0f, 25.0f);
+    ChangeDetector detector(20.0f, 60.0f, 5000);
+    Reconstruction result;
+    float shown = 0;
+    unsigned long lastRead = 0;
+
+    for (unsigned long now = 0; now < DAY; now += 10)
+    {
+        bool due = sampler ? sampler->due(now) : (now == 0 || now - lastRead >= BASELINE_INTERVAL);
+        if (due)
+        {
+            shown = std::round(ldrTruth(now) + noise(rng));
+            if (sampler)
+                sampler->schedule(detector.update(shown, sampler->elapsed(now)), now);
+            lastRead = now;
+            result.reads++;
+        }
+        if (now % 100 == 0 && now >= WARMUP)
+            result.measure(shown, ldrTruth(now));
+    }
+    return result;
+}
+
+// DHT11 (temperatura e humidade na mesma leitura, 1 C / 1 %)
+static void reconstructDht(AdaptiveSampler *sampler, uint32_t seed, Reconstruction &temperature,
+                           Reconstruction &humidity)
+{
+    std::mt19937 rng(seed);
+    std::normal_distribution<float> noise(0.0f, 0.3f);
+    ChangeDetector temperatureChange(0.02f, 0.6f, 30000);
+    ChangeDetector humidityChange(0.1f, 1.5f, 30000);
+    float shownTemperature = 0;
+    float shownHumidity = 0;
+    unsigned long lastRead = 0;
+
+    for (unsigned long now = 0; now < DAY; now += 10)
+    {
+        bool due = sampler ? sampler->due(now) : (now == 0 || now - lastRead >= BASELINE_INTERVAL);
+        if (due)
+        {
+            shownTemperature = std::round(temperatureTruth(now) + noise(rng));
+            shownHumidity = std::round(humidityTruth(now) + noise(rng));
+            if (sampler)
+            {
+                unsigned long dt = sampler->elapsed(now);
+                bool active = temperatureChange.update(shownTemperature, dt);
+                active |= humidityChange.update(shownHumidity, dt);
+                sampler->schedule(active, now);
+            }
+            lastRead = now;
+            temperature.reads++;
+            humidity.reads++;
+        }
+        if (now % 100 == 0 && now >= WARMUP)
+        {
+            temperature.measure(shownTemperature, temperatureTruth(now));
+            humidity.measure(shownHumidity, humidityTruth(now));
+        }
+    }
+}
+
+static void report(const char *signal, const Reconstruction &adaptive, const Reconstruction &baseline)
+{
+    char message[200];
+    snprintf(message, sizeof(message),
+             "%-12s leituras %6lu x %6lu (%5.1f%%) | RMS %7.2f x %7.2f | max %7.2f x %7.2f",
+             signal, adaptive.reads, baseline.reads, 100.0 * adaptive.reads / baseline.reads, adaptive.rms(),
+             baseline.rms(), adaptive.maxError, baseline.maxError);
+    TEST_MESSAGE(message);
+}
+
+// LDR: com o máximo de 5 s não há economia de leituras (ler é barato);
+// o que se confere é que o erro não piora em relação à leitura fixa
+void test_ldr_reads_vs_error_against_fixed_5s()
+{
+    AdaptiveSampler sampler(LDR_MIN_INTERVAL, LDR_MAX_INTERVAL);
+    Reconstruction adaptive = reconstructLdr(&sampler, 11);
+    Reconstruction baseline = reconstructLdr(nullptr, 11);
+    report("luminosidade", adaptive, baseline);
+
+    // Nunca lê menos que a leitura fixa e, no máximo, 2x mais no dia
+    TEST_ASSERT_TRUE(adaptive.reads >= baseline.reads - 1);
+    TEST_ASSERT_TRUE(adaptive.reads <= 2 * baseline.reads);
+    // Erro: o degrau fica no máximo 5 s sem ser visto, como na leitura fixa.
+    // O resto é o ruído do ADC (desvio 25).
+    TEST_ASSERT_TRUE(adaptive.rms() <= baseline.rms() * 1.1);
+    TEST_ASSERT_TRUE(adaptive.maxError <= baseline.maxError + 100.0);
+    TEST_ASSERT_TRUE(adaptive.rms() < 40.0); // ~1 % da escala do ADC
+}
+
+// DHT: sinais lentos; a economia vem dos períodos estáveis
+void test_dht_reads_vs_error_against_fixed_5s()
+{
+    Reconstruction adaptiveTemperature;
+    Reconstruction adaptiveHumidity;
+    Reconstruction baselineTemperature;
+    Reconstruction baselineHumidity;
+    AdaptiveSampler sampler(DHT_MIN_INTERVAL, DHT_MAX_INTERVAL);
+    reconstructDht(&sampler, 12, adaptiveTemperature, adaptiveHumidity);
+    reconstructDht(nullptr, 12, baselineTemperature, baselineHumidity);
+    report("temperatura", adaptiveTemperature, baselineTemperature);
+    report("humidade", adaptiveHumidity, baselineHumidity);
+
+    // Ao menos 3x menos leituras que a leitura fixa de 5 s...
+    TEST_ASSERT_TRUE(adaptiveTemperature.reads * 3 <= baselineTemperature.reads);
+    // ...com o erro médio dentro da resolução do DHT11 (1 C / 1 %)
+    TEST_ASSERT_TRUE(adaptiveTemperature.rms() <= baselineTemperature.rms() + 0.25);
+    TEST_ASSERT_TRUE(adaptiveHumidity.rms() <= baselineHumidity.rms() + 0.25);
+    // O pior caso é o começo de uma subida rápida (banho: 5 %/min) no
+    // intervalo máximo de 60 s: fica dentro da precisão do DHT11 (2 C / 5 %)
+    TEST_ASSERT_TRUE(adaptiveTemperature.maxError <= 2.0);
+    TEST_ASSERT_TRUE(adaptiveHumidity.maxError <= 5.5);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_ldr_noise_backs_off);
+    RUN_TEST(test_decision_does_not_depend_on_read_rate);
+    RUN_TEST(test_ldr_step_returns_to_min);
+    RUN_TEST(test_dht_quantisation_flicker_backs_off);
+    RUN_TEST(test_dht_ramp_is_detected);
+    RUN_TEST(test_hysteresis_holds_near_threshold);
+    RUN_TEST(test_ldr_reads_vs_error_against_fixed_5s);
+    RUN_TEST(test_dht_reads_vs_error_against_fixed_5s);
+    return UNITY_END();
+}
@@ -0,0 +1,152 @@
+// Testes do formato do beacon (BeaconPacket.h) no PC: pio test -e native
+//
+// O mesmo cabeçalho é usado no firmware e nas ferramentas Linux, então
+// um erro aqui passa despercebido nos dois lados. Confere o layout byte a
+// byte, a volta encode -> decode e a rejeição de pacotes inválidos.
+
+#include <unity.h>
+
+#include <cstring>
+
+#include "BeaconPacket.h"
+
+static BeaconStatus sampleStatus()
+{
+    BeaconStatus status = {};
+    status.flags = BEACON_FLAG_CHANGE | BEACON_FLAG_TIME_SYNC;
+    status.deviceId = 0xA1B2C3D4;
+    status.sequence = 0x01020304;
+    status.uptime = 86400 * 3 + 17;
+    status.temperature = -35; // -3.5 C
+    status.humidity = 655;
+    status.luminosity = 4095;
+    status.pwm = 200;
+    status.onMinutes = 6 * 60 + 30;
+    status.offMinutes = 22 * 60;
+    status.maxLight = 80;
+    return status;
+}
+
+static void assertSameStatus(const BeaconStatus &expected, const BeaconStatus &actual)
+{
+    TEST_ASSERT_EQUAL(BEACON_VERSION, actual.version);
+    TEST_ASSERT_EQUAL(expected.flags, actual.flags);
+    TEST_ASSERT_EQUAL_UINT32(expected.deviceId, actual.deviceId);
+    TEST_ASSERT_EQUAL_UINT32(expected.sequence, actual.sequence);
+    TEST_ASSERT_EQUAL_UINT32(expected.uptime, actual.uptime);
+    TEST_ASSERT_EQUAL_INT16(expected.temperature, actual.temperature);
+    TEST_ASSERT_EQUAL_UINT16(expected.humidity, actual.humidity);
+    TEST_ASSERT_EQUAL_UINT16(expected.luminosity, actual.luminosity);
+    TEST_ASSERT_EQUAL_UINT16(expected.pwm, actual.pwm);
+    TEST_ASSERT_EQUAL_UINT16(expected.onMinutes, actual.onMinutes);
+    TEST_ASSERT_EQUAL_UINT16(expected.offMinutes, actual.offMinutes);
+    TEST_ASSERT_EQUAL_UINT8(expected.maxLight, actual.maxLight);
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_round_trip()
+{
+    BeaconStatus status = sampleStatus();
+    uint8_t packet[BEACON_PACKET_SIZE];
+    TEST_ASSERT_EQUAL(BEACON_PACKET_SIZE, beaconEncode(status, packet, sizeof(packet)));
+
+    BeaconStatus decoded;
+    TEST_ASSERT_TRUE(beaconDecode(packet, sizeof(packet), decoded));
+    assertSameStatus(status, decoded);
+}
+
+void test_no_reading_values_survive()
+{
+    BeaconStatus status = sampleStatus();
+    status.temperature = BEACON_NO_TEMPERATURE;
+    status.humidity = BEACON_NO_HUMIDITY;
+    uint8_t packet[BEACON_PACKET_SIZE];
+    beaconEncode(status, packet, sizeof(packet));
+
+    BeaconStatus decoded;
+    TEST_ASSERT_TRUE(beaconDecode(packet, sizeof(packet), decoded));
+    TEST_ASSERT_EQUAL_INT16(BEACON_NO_TEMPERATURE, decoded.temperature);
+    TEST_ASSERT_EQUAL_UINT16(BEACON_NO_HUMIDITY, decoded.humidity);
+}
+
+// Layout fixo, little-endian, independente da máquina
+void test_wire_layout()
+{
+    BeaconStatus status = sampleStatus();
+    uint8_t packet[BEACON_PACKET_SIZE];
+    beaconEncode(status, packet, sizeof(packet));
+
+    const uint8_t header[] = {'P', 'L', 'D', 'B', BEACON_VERSION, BEACON_FLAG_CHANGE | BEACON_FLAG_TIME_SYNC,
+                              BEACON_PACKET_SIZE, 0, 0xD4, 0xC3, 0xB2, 0xA1, 0x04, 0x03, 0x02, 0x01};
+    TEST_ASSERT_EQUAL_MEMORY(header, packet, sizeof(header));
+    TEST_ASSERT_EQUAL_UINT8(0xDD, packet[20]); // -35 = 0xFFDD
+    TEST_ASSERT_EQUAL_UINT8(0xFF, packet[21]);
+    TEST_ASSERT_EQUAL_UINT8(80, packet[32]);
+    for (size_t i = 33; i < BEACON_PACKET_SIZE; i++)
+        TEST_ASSERT_EQUAL_UINT8(0, packet[i]); // Reservados
+}
+
+void test_encode_rejects_small_buffer()
+{
+    uint8_t packet[BEACON_PACKET_SIZE - 1];
+    TEST_ASSERT_EQUAL(0, beaconEncode(sampleStatus(), packet, sizeof(packet)));
+}
+
+void test_decode_rejects_invalid()
+{
+    uint8_t packet[BEACON_PACKET_SIZE];
+    beaconEncode(sampleStatus(), packet, sizeof(packet));
+    BeaconStatus decoded;
+
+    // Curto
+    TEST_ASSERT_FALSE(beaconDecode(packet, BEACON_PACKET_SIZE - 1, decoded));
+
+    // Magic errado
+    uint8_t bad[BEACON_PACKET_SIZE];
+    memcpy(bad, packet, sizeof(bad));
+    bad[0] = 'X';
+    TEST_ASSERT_FALSE(beaconDecode(bad, sizeof(bad), decoded));
+
+    // Versão 0
+    memcpy(bad, packet, sizeof(bad));
+    bad[4] = 0;
+    TEST_ASSERT_FALSE(beaconDecode(bad, sizeof(bad), decoded));
+
+    // Tamanho declarado menor que o v1, ou maior que o recebido
+    memcpy(bad, packet, sizeof(bad));
+    bad[6] = BEACON_PACKET_SIZE - 1;
+    TEST_ASSERT_FALSE(beaconDecode(bad, sizeof(bad), decoded));
+    bad[6] = BEACON_PACKET_SIZE + 1;
+    TEST_ASSERT_FALSE(beaconDecode(bad, sizeof(bad), decoded));
+}
+
+// Versões novas só acrescentam campos no fim: um leitor v1 lê o começo
+void test_decode_accepts_newer_version()
+{
+    uint8_t packet[BEACON_PACKET_SIZE + 8];
+    BeaconStatus status = sampleStatus();
+    beaconEncode(status, packet, sizeof(packet));
+    packet[4] = BEACON_VERSION + 1;
+    packet[6] = sizeof(packet);
+    memset(packet + BEACON_PACKET_SIZE, 0xEE, 8);
+
+    BeaconStatus decoded;
+    TEST_ASSERT_TRUE(beaconDecode(packet, sizeof(packet), decoded));
+    TEST_ASSERT_EQUAL(BEACON_VERSION + 1, decoded.version);
+    TEST_ASSERT_EQUAL_UINT32(status.sequence, decoded.sequence);
+    TEST_ASSERT_EQUAL_UINT8(status.maxLight, decoded.maxLight);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_round_trip);
+    RUN_TEST(test_no_reading_values_survive);
+    RUN_TEST(test_wire_layout);
+    RUN_TEST(test_encode_rejects_small_buffer);
+    RUN_TEST(test_decode_rejects_invalid);
+    RUN_TEST(test_decode_accepts_newer_version);
+    return UNITY_END();
+}
@@ -0,0 +1,282 @@
+// Benchmark do SensorHistory no PC: pio test -e native
+//
+// Compara a árvore de segmentos com a alternativa sem árvore: o mesmo
+// buffer circular de intervalos de 1 h, consultado varrendo as folhas da
+// faixa. Os dois recebem as mesmas amostras (32 dias, DHT e LDR a cada
+// 5 s) e respondem as consultas do dashboard. Mede o tempo no PC, os nós
+// lidos por consulta (independe da máquina) e a memória de cada um.
+
+#include <unity.h>
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+
+#include "SensorHistory.h"
+
+static const time_t START = 1760000000; // Out/2025, depois do MIN_VALID_TIME
+static const time_t DAYS = 32;
+static const time_t SAMPLE_SECONDS = 5;
+
+/**
+ * Alternativa sem árvore: só as folhas (HISTORY_BUCKETS nós), e cada
+ * consulta junta uma a uma as folhas da faixa.
+ */
+struct FlatHistory
+{
+    HistoryNode leaves[HISTORY_BUCKETS];
+    int32_t lastBucket = -1;
+    int32_t openSum[HISTORY_CHANNELS];
+    uint16_t openCount[HISTORY_CHANNELS];
+    mutable unsigned long nodesRead = 0;
+
+    FlatHistory()
+    {
+        for (HistoryNode &leaf : leaves)
+            leaf.clear();
+    }
+
+    HistoryNode *open(time_t when)
+    {
+        int32_t bucket = when / HISTORY_BUCKET_SECONDS;
+        if (bucket < lastBucket)
+            return nullptr;
+        if (bucket > lastBucket)
+        {
+            int32_t first = lastBucket < 0 || bucket - lastBucket > HISTORY_BUCKETS ? bucket - HISTORY_BUCKETS + 1
+                                                                                      : lastBucket + 1;
+            for (int32_t b = first; b <= bucket; b++)
+                leaves[b % HISTORY_BUCKETS].clear();
+            lastBucket = bucket;
+            for (int c = 0; c < HISTORY_CHANNELS; c++)
+            {
+                openSum[c] = 0;
+                openCount[c] = 0;
+            }
+        }
+        return &leaves[bucket % HISTORY_BUCKETS];
+    }
+
+    void add(HistoryNode &node, int c, int16_t value)
+    {
+        openSum[c] += value;
+        openCount[c]++;
+        if (value < node.min[c])
+            node.min[c] = value;
+        if (value > node.max[c])
+            node.max[c] = value;
+        node.sum[c] = openSum[c] / openCount[c];
+        node.count[c] = 1;
+    }
+
+    void appendClimate(time_t when, float temperature, float humidity)
+    {
+        HistoryNode *node = open(when);
+        if (node == nullptr)
+            return;
+        add(*node, HISTORY_TEMPERATURE, (int16_t)lroundf(temperature * 10));
+        add(*node, HISTORY_HUMIDITY, (int16_t)lroundf(humidity * 10));
+    }
+
+    void appendLight(time_t when, int luminosity)
+    {
+        HistoryNode *node = open(when);
+        if (node != nullptr)
+            add(*node, HISTORY_LUMINOSITY, (int16_t)luminosity);
+    }
+
+    bool query(time_t from, time_t to, HistoryNode &out) const
+    {
+        out.clear();
+        int64_t first = (int64_t)from / HISTORY_BUCKET_SECONDS;
+        int64_t last = (int64_t)to / HISTORY_BUCKET_SECONDS;
+        if (first < (int64_t)lastBucket - HISTORY_BUCKETS + 1)
+            first = (int64_t)lastBucket - HISTORY_BUCKETS + 1;
+        if (last > lastBucket)
+            last = lastBucket;
+        for (int64_t b = first; b <= last; b++)
+        {
+            out.merge(leaves[b % HISTORY_BUCKETS]);
+            nodesRead++;
+        }
+        return !out.empty();
+    }
+};
+
+// Nós que o SensorHistory::queryLeaves() lê para [first, last] (mesmo laço)
+static unsigned long treeNodesRead(size_t first, size_t last)
+{
+    unsigned long nodes = 0;
+    for (size_t l = first + HISTORY_BUCKETS, r = last + HISTORY_BUCKETS + 1; l < r; l /= 2, r /= 2)
+    {
+        nodes += l & 1;
+        nodes += r & 1;
+        l += l & 1;
+        r -= r & 1;
+    }
+    return nodes;
+}
+
+static time_t now; // Hora da última amostra
+
+// Mesmo corte à janela guardada que o SensorHistory::query() faz
+static unsigned long treeNodesRead(time_t from, time_t to)
+{
+    int64_t lastBucket = now / HISTORY_BUCKET_SECONDS;
+    int64_t first = (int64_t)from / HISTORY_BUCKET_SECONDS;
+    int64_t last = (int64_t)to / HISTORY_BUCKET_SECONDS;
+    if (first < lastBucket - HISTORY_BUCKETS + 1)
+        first = lastBucket - HISTORY_BUCKETS + 1;
+    if (last > lastBucket)
+        last = lastBucket;
+    if (first > last)
+        return 0;
+    size_t firstLeaf = first % HISTORY_BUCKETS;
+    size_t lastLeaf = last % HISTORY_BUCKETS;
+    if (firstLeaf <= lastLeaf)
+        return treeNodesRead(firstLeaf, lastLeaf);
+    return treeNodesRead(firstLeaf, HISTORY_BUCKETS - 1) + treeNodesRead(0, lastLeaf);
+}
+
+static SensorHistory history;
+static FlatHistory flat;
+
+// Consulta do dashboard: [from, to] em 'points' pontos (como o writeJson)
+struct Workload
+{
+    const char *name;
+    time_t span;
+    uint32_t points;
+};
+
+static const Workload WORKLOADS[] = {
+    {"24 h, 24 pontos", 86400, 24},
+    {"7 dias, 84 pontos", 7 * 86400, 84},
+    {"31 dias, 93 pontos", 31 * 86400, 93},
+    {"31 dias, 1 ponto", 31 * 86400, 1},
+};
+
+template <class Query>
+static double runWorkload(const Workload &w, int repeat, Query query)
+{
+    time_t from = now - w.span + 1;
+    time_t step = w.span / w.points;
+    volatile int32_t sink = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < repeat; r++)
+    {
+        for (uint32_t i = 0; i < w.points; i++)
+        {
+            time_t t = from + (time_t)i * step;
+            HistoryNode node;
+            query(t, i + 1 == w.points ? now : t + step - 1, node);
+            sink = sink + node.sum[HISTORY_LUMINOSITY];
+        }
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::micro>(elapsed).count() / repeat;
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_both_give_the_same_answers()
+{
+    for (const Workload &w : WORKLOADS)
+    {
+        time_t from = now - w.span + 1;
+        time_t step = w.span / w.points;
+        for (uint32_t i = 0; i < w.points; i++)
+        {
+            time_t t = from + (time_t)i * step;
+            time_t end = i + 1 == w.points ? now : t + step - 1;
+            HistoryNode a;
+            HistoryNode b;
+            TEST_ASSERT_EQUAL(history.query(t, end, a), flat.query(t, end, b));
+            for (int c = 0; c < HISTORY_CHANNELS; c++)
+            {
+                TEST_ASSERT_EQUAL(b.count[c], a.count[c]);
+                TEST_ASSERT_EQUAL(b.sum[c], a.sum[c]);
+                TEST_ASSERT_EQUAL_INT16(b.min[c], a.min[c]);
+                TEST_ASSERT_EQUAL_INT16(b.max[c], a.max[c]);
+            }
+        }
+    }
+}
+
+void test_query_cost()
+{
+    char message[160];
+    for (const Workload &w : WORKLOADS)
+    {
+        time_t from = now - w.span + 1;
+        time_t step = w.span / w.points;
+
+        unsigned long treeNodes = 0;
+        flat.nodesRead = 0;
+        for (uint32_t i = 0; i < w.points; i++)
+        {
+            time_t t = from + (time_t)i * step;
+            time_t end = i + 1 == w.points ? now : t + step - 1;
+            HistoryNode node;
+            flat.query(t, end, node);
+            treeNodes += treeNodesRead(t, end);
+        }
+        unsigned long flatNodes = flat.nodesRead;
+
+        const int repeat = 2000;
+        double treeUs = runWorkload(w, repeat, [](time_t a, time_t b, HistoryNode &n) { history.query(a, b, n); });
+        double flatUs = runWorkload(w, repeat, [](time_t a, time_t b, HistoryNode &n) { flat.query(a, b, n); });
+
+        snprintf(message, sizeof(message), "%-20s arvore: %4lu nos, %7.2f us | varredura: %4lu nos, %7.2f us",
+                 w.name, treeNodes, treeUs, flatNodes, flatUs);
+        TEST_MESSAGE(message);
+
+        // A árvore nunca lê mais nós que a varredura
+        TEST_ASSERT_TRUE(treeNodes <= flatNodes);
+    }
+
+    // Faixa de um mês inteiro: O(log n) contra O(n)
+    TEST_ASSERT_TRUE(treeNodesRead(now - 31 * 86400 + 1, now) * 10 < 31 * 24);
+}
+
+void test_memory()
+{
+    size_t tree = 2 * HISTORY_BUCKETS * sizeof(HistoryNode);
+    size_t leaves = HISTORY_BUCKETS * sizeof(HistoryNode);
+    // Guardar as leituras cruas (3 canais x int16 + hora) em vez de agregados
+    size_t raw = (size_t)(DAYS * 86400 / SAMPLE_SECONDS) * (3 * sizeof(int16_t) + sizeof(uint32_t));
+
+    char message[160];
+    snprintf(message, sizeof(message), "Memoria: arvore %zu B (%zu nos de %zu B), varredura %zu B, leituras cruas %zu B",
+             tree, 2 * (size_t)HISTORY_BUCKETS, sizeof(HistoryNode), leaves, raw);
+    TEST_MESSAGE(message);
+    TEST_ASSERT_EQUAL(2 * leaves, tree);
+}
+
+int main(int argc, char **argv)
+{
+    // 32 dias de leituras a cada 5 s, sinais com ciclo diário
+    std::mt19937 rng(7);
+    if (!history.begin())
+        return 1;
+    for (now = START; now < START + DAYS * 86400; now += SAMPLE_SECONDS)
+    {
+        double day = (now % 86400) / 86400.0;
+        float temperature = 22.0f + 4.0f * (float)sin(day * 6.2832) + (rng() % 10) / 10.0f;
+        float humidity = 55.0f - 10.0f * (float)sin(day * 6.2832) + (rng() % 10) / 10.0f;
+        int luminosity = (int)(2000 + 1800 * sin(day * 6.2832)) + (int)(rng() % 50);
+        history.appendClimate(now, temperature, humidity);
+        history.appendLight(now, luminosity);
+        flat.appendClimate(now, temperature, humidity);
+        flat.appendLight(now, luminosity);
+    }
+    now -= SAMPLE_SECONDS;
+
+    UNITY_BEGIN();
+    RUN_TEST(test_both_give_the_same_answers);
+    RUN_TEST(test_query_cost);
+    RUN_TEST(test_memory);
+    return UNITY_END();
+}
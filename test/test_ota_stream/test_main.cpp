@@ -0,0 +1,350 @@
+// Testes do motor de OTA (lib/OtaStream) no PC: pio test -e native
+//
+// Compara a descompressão com o zlib do sistema, aplica patches gerados
+// pelo DeltaEncoder e mede a vazão (MB/s) e o tamanho da transferência.
+
+#include <unity.h>
+#include <zlib.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "DeltaEncoder.h"
+#include "DeltaPatch.h"
+#include "StreamInflate.h"
+
+typedef std::vector<uint8_t> Bytes;
+
+static bool collect(void *ctx, const uint8_t *data, size_t len)
+{
+    Bytes *out = (Bytes *)ctx;
+    out->insert(out->end(), data, data + len);
+    return true;
+}
+
+static bool readSource(void *ctx, uint32_t offset, uint8_t *data, size_t len)
+{
+    const Bytes *source = (const Bytes *)ctx;
+    if (offset + len > source->size())
+        return false;
+    memcpy(data, source->data() + offset, len);
+    return true;
+}
+
+static Bytes compress(const Bytes &data, int level)
+{
+    uLongf size = compressBound(data.size());
+    Bytes out(size);
+    compress2(out.data(), &size, data.data(), data.size(), level);
+    out.resize(size);
+    return out;
+}
+
+// Texto repetitivo: gera blocos dinâmicos com distâncias longas
+static Bytes makeText(size_t size, uint32_t seed)
+{
+    static const char *words[] = {"temperatura", "humidade", "luminosidade", "pwm", "hora_ligar",
+                                  "hora_desligar", "luz_maxima", "{", "}", ":", ",", " "};
+    std::mt19937 rng(seed);
+    Bytes out;
+    while (out.size() < size)
+    {
+        const char *word = words[rng() % 12];
+        out.insert(out.end(), word, word + strlen(word));
+        if (rng() % 5 == 0)
+            out.push_back('0' + rng() % 10);
+    }
+    out.resize(size);
+    return out;
+}
+
+static Bytes makeRandom(size_t size, uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    Bytes out(size);
+    for (uint8_t &b : out)
+        b = (uint8_t)rng();
+    return out;
+}
+
+/**
+ * Imagem sintética parecida com firmware: instruções de 3 bytes e
+ * endereços absolutos de 32 bits para outras instruções. 'insertAt' e
+ * 'insertSize' simulam uma função nova no meio: tudo o que vem depois
+ * muda de endereço, como num build real.
+ */
+static Bytes makeFirmware(size_t instructions, uint32_t seed, size_t insertAt = 0, size_t insertSize = 0)
+{
+    struct Instruction
+    {
+        bool address;
+        uint8_t bytes[3];
+        size_t target;
+    };
+
+    std::mt19937 rng(seed);
+    std::vector<Instruction> program(instructions);
+    for (Instruction &in : program)
+    {
+        in.address = rng() % 5 == 0;
+        in.bytes[0] = (uint8_t)(0x20 + rng() % 6);
+        in.bytes[1] = (uint8_t)(rng() % 4);
+        in.bytes[2] = (uint8_t)(rng() % 16);
+        in.target = rng() % instructions;
+    }
+
+    // Endereço de cada instrução na imagem montada
+    std::vector<uint32_t> offsets(instructions);
+    uint32_t offset = 1;
+    for (size_t i = 0; i < instructions; i++)
+    {
+        if (insertSize > 0 && i == insertAt)
+            offset += insertSize;
+        offsets[i] = offset;
+        offset += program[i].address ? 4 : 3;
+    }
+
+    Bytes out;
+    out.push_back(0xE9);
+    std::mt19937 extra(seed + 1);
+    for (size_t i = 0; i < instructions; i++)
+    {
+        if (insertSize > 0 && i == insertAt)
+        {
+            for (size_t k = 0; k < insertSize; k++)
+                out.push_back((uint8_t)(0x20 + extra() % 6));
+        }
+        if (program[i].address)
+        {
+            uint32_t address = 0x400D0000 + offsets[program[i].target];
+            for (int k = 0; k < 4; k++)
+                out.push_back((uint8_t)(address >> (8 * k)));
+        }
+        else
+        {
+            out.insert(out.end(), program[i].bytes, program[i].bytes + 3);
+        }
+    }
+    return out;
+}
+
+// Descomprime em pedaços de tamanho aleatório (1 a maxChunk bytes)
+static bool inflateChunks(const Bytes &compressed, Bytes &out, size_t maxChunk, uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    StreamInflate inflater;
+    if (!inflater.begin(collect, &out))
+        return false;
+    size_t pos = 0;
+    while (pos < compressed.size())
+    {
+        size_t n = 1 + rng() % maxChunk;
+        if (n > compressed.size() - pos)
+            n = compressed.size() - pos;
+        if (!inflater.write(compressed.data() + pos, n))
+            return false;
+        pos += n;
+    }
+    return inflater.finished();
+}
+
+// Pipeline do OtaUpdater: zlib -> patch -> imagem nova
+struct PatchPipeline
+{
+    StreamInflate inflater;
+    DeltaPatch patch;
+    Bytes out;
+
+    static bool toPatch(void *ctx, const uint8_t *data, size_t len)
+    {
+        return ((PatchPipeline *)ctx)->patch.write(data, len);
+    }
+
+    bool run(const Bytes &source, const Bytes &compressedPatch, size_t chunk)
+    {
+        patch.begin(readSource, (void *)&source, collect, &out);
+        if (!inflater.begin(toPatch, this))
+            return false;
+        for (size_t pos = 0; pos < compressedPatch.size(); pos += chunk)
+        {
+            size_t n = std::min(chunk, compressedPatch.size() - pos);
+            if (!inflater.write(compressedPatch.data() + pos, n))
+                return false;
+        }
+        return inflater.finished() && patch.finished();
+    }
+};
+
+void setUp() {}
+void tearDown() {}
+
+void test_inflate_matches_zlib()
+{
+    const Bytes inputs[] = {makeText(300000, 1), makeRandom(70000, 2), makeFirmware(40000, 3), Bytes(100000, 0xFF)};
+    const int levels[] = {0, 1, 6, 9};
+
+    for (const Bytes &input : inputs)
+    {
+        for (int level : levels)
+        {
+            Bytes compressed = compress(input, level);
+            Bytes out;
+            TEST_ASSERT_TRUE(inflateChunks(compressed, out, 4096, level));
+            TEST_ASSERT_EQUAL(input.size(), out.size());
+            TEST_ASSERT_EQUAL_MEMORY(input.data(), out.data(), input.size());
+        }
+    }
+}
+
+void test_inflate_byte_by_byte()
+{
+    Bytes input = makeText(80000, 4);
+    Bytes compressed = compress(input, 9);
+    Bytes out;
+    TEST_ASSERT_TRUE(inflateChunks(compressed, out, 1, 0));
+    TEST_ASSERT_EQUAL(input.size(), out.size());
+    TEST_ASSERT_EQUAL_MEMORY(input.data(), out.data(), input.size());
+}
+
+void test_inflate_rejects_corruption()
+{
+    Bytes input = makeText(50000, 5);
+    Bytes compressed = compress(input, 6);
+
+    // Adler-32 trocado
+    Bytes badTrailer = compressed;
+    badTrailer.back() ^= 0x01;
+    Bytes out;
+    TEST_ASSERT_FALSE(inflateChunks(badTrailer, out, 512, 0));
+
+    // Fluxo truncado: não termina
+    Bytes truncated(compressed.begin(), compressed.end() - 10);
+    out.clear();
+    TEST_ASSERT_FALSE(inflateChunks(truncated, out, 512, 0));
+
+    // Cabeçalho que não é zlib
+    Bytes badHeader = compressed;
+    badHeader[0] = 0xE9;
+    out.clear();
+    TEST_ASSERT_FALSE(inflateChunks(badHeader, out, 512, 0));
+
+    // Bytes trocados no meio: erro de código ou de Adler-32, nunca sucesso
+    for (size_t i = 10; i < compressed.size() - 4; i += compressed.size() / 7)
+    {
+        Bytes corrupt = compressed;
+        corrupt[i] ^= 0x5A;
+        out.clear();
+        TEST_ASSERT_FALSE(inflateChunks(corrupt, out, 512, (uint32_t)i));
+    }
+}
+
+void test_crc32_matches_zlib()
+{
+    Bytes data = makeRandom(10000, 6);
+    TEST_ASSERT_EQUAL_UINT32(crc32(0, data.data(), data.size()), deltaCrc32(0, data.data(), data.size()));
+}
+
+void test_delta_round_trip()
+{
+    Bytes source = makeFirmware(200000, 7);
+    Bytes target = makeFirmware(200000, 7, 80000, 2048);
+
+    Bytes patch = deltaEncode(source.data(), source.size(), target.data(), target.size());
+    Bytes compressedPatch = compress(patch, 9);
+
+    PatchPipeline pipeline;
+    TEST_ASSERT_TRUE(pipeline.run(source, compressedPatch, 1460)); // Segmento TCP típico
+    TEST_ASSERT_EQUAL(target.size(), pipeline.out.size());
+    TEST_ASSERT_EQUAL_MEMORY(target.data(), pipeline.out.data(), target.size());
+
+    // O delta comprimido tem que ser bem menor que a imagem inteira comprimida
+    Bytes full = compress(target, 9);
+    char message[128];
+    snprintf(message, sizeof(message), "imagem %zu B, zlib %zu B, delta+zlib %zu B",
+             target.size(), full.size(), compressedPatch.size());
+    TEST_MESSAGE(message);
+    TEST_ASSERT_LESS_THAN(full.size() / 4, compressedPatch.size());
+}
+
+void test_delta_rejects_other_source()
+{
+    Bytes source = makeFirmware(20000, 8);
+    Bytes target = makeFirmware(20000, 8, 5000, 64);
+    Bytes patch = compress(deltaEncode(source.data(), source.size(), target.data(), target.size()), 6);
+
+    Bytes other = source;
+    other[100] ^= 0xFF;
+    PatchPipeline pipeline;
+    TEST_ASSERT_FALSE(pipeline.run(other, patch, 512));
+    TEST_ASSERT_TRUE(pipeline.out.empty()); // Nada sai antes de conferir a origem
+}
+
+void test_delta_rejects_truncated_patch()
+{
+    Bytes source = makeFirmware(20000, 9);
+    Bytes target = makeFirmware(20000, 9, 100, 300);
+    Bytes patch = deltaEncode(source.data(), source.size(), target.data(), target.size());
+
+    Bytes out;
+    DeltaPatch applier;
+    applier.begin(readSource, &source, collect, &out);
+    TEST_ASSERT_TRUE(applier.write(patch.data(), patch.size() - 1));
+    TEST_ASSERT_FALSE(applier.finished());
+
+    // Byte a mais depois do fim
+    Bytes extra = patch;
+    extra.push_back('L');
+    out.clear();
+    applier.begin(readSource, &source, collect, &out);
+    TEST_ASSERT_FALSE(applier.write(extra.data(), extra.size()));
+}
+
+// Vazão do inflate e do patch no PC. No ESP32 o gargalo é a flash.
+void test_benchmark()
+{
+    typedef std::chrono::steady_clock Clock;
+    char message[160];
+
+    Bytes firmware = makeFirmware(1000000, 10); // ~3.2 MB
+    Bytes compressed = compress(firmware, 9);
+    Bytes out;
+    out.reserve(firmware.size());
+
+    Clock::time_point t0 = Clock::now();
+    TEST_ASSERT_TRUE(inflateChunks(compressed, out, 1460, 0));
+    double seconds = std::chrono::duration<double>(Clock::now() - t0).count();
+    snprintf(message, sizeof(message), "inflate: %.1f MB/s (%zu -> %zu B)",
+             firmware.size() / seconds / 1e6, compressed.size(), firmware.size());
+    TEST_MESSAGE(message);
+
+    Bytes target = makeFirmware(1000000, 10, 400000, 4096);
+    Bytes patch = compress(deltaEncode(firmware.data(), firmware.size(), target.data(), target.size()), 9);
+    PatchPipeline pipeline;
+    pipeline.out.reserve(target.size());
+
+    t0 = Clock::now();
+    TEST_ASSERT_TRUE(pipeline.run(firmware, patch, 1460));
+    seconds = std::chrono::duration<double>(Clock::now() - t0).count();
+    snprintf(message, sizeof(message), "inflate+patch: %.1f MB/s (%zu B transferidos, imagem de %zu B)",
+             target.size() / seconds / 1e6, patch.size(), target.size());
+    TEST_MESSAGE(message);
+    TEST_ASSERT_EQUAL_MEMORY(target.data(), pipeline.out.data(), target.size());
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_inflate_matches_zlib);
+    RUN_TEST(test_inflate_byte_by_byte);
+    RUN_TEST(test_inflate_rejects_corruption);
+    RUN_TEST(test_crc32_matches_zlib);
+    RUN_TEST(test_delta_round_trip);
+    RUN_TEST(test_delta_rejects_other_source);
+    RUN_TEST(test_delta_rejects_truncated_patch);
+    RUN_TEST(test_benchmark);
+    return UNITY_END();
+}
@@ -0,0 +1,313 @@
+// Teste de resistência do RequestArena no PC: pio test -e native
+//
+// Simula muitas requisições do /data.json (JsonDocument no arena, reset
+// depois de cada uma) e confere que nada vai para o heap, que o arena
+// volta a zero e que o pico de uso não cresce com o tempo.
+//
+// Precisa do ArduinoJson 7 de verdade (lib_deps do env native): o que
+// importa aqui é como ele aloca os pools de slots.
+
+#include <unity.h>
+
+// Pools de 128 slots, como no ESP32; o padrão com ponteiros de 64 bits é 256
+#define ARDUINOJSON_POOL_CAPACITY 128
+#include <ArduinoJson.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+#include "RequestArena.h"
+
+// --- Contador de alocações do operator new (tudo o que é C++ e não passa pelo arena) ---
+static size_t heapAllocations = 0;
+
+void *operator new(size_t size)
+{
+    heapAllocations++;
+    void *p = malloc(size);
+    if (p == nullptr)
+        throw std::bad_alloc();
+    return p;
+}
+
+void operator delete(void *p) noexcept
+{
+    free(p);
+}
+
+void operator delete(void *p, size_t) noexcept
+{
+    free(p);
+}
+
+// Bytes em uso no heap do C (malloc), quando a libc informa
+static size_t heapInUse()
+{
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 33)
+    return mallinfo2().uordblks;
+#else
+    return 0;
+#endif
+}
+
+// Folga para o soak no PC: com ponteiros de 64 bits slots e cabeçalhos são
+// maiores que no ESP32. O orçamento do firmware é conferido à parte, em
+// test_firmware_arena_budget.
+static const size_t ARENA_SIZE = 2 * 4096;
+static const unsigned long REQUESTS = 200000;
+
+static uint8_t arenaBuffer[ARENA_SIZE];
+
+// Mesmo conteúdo do DashboardServer::renderData() + preencherDados() do main.cpp
+static size_t renderData(RequestArena &arena, unsigned long i, char *out, size_t size)
+{
+    JsonDocument doc(&arena);
+
+    char dateStr[20];
+    char timeStr[20];
+    snprintf(dateStr, sizeof(dateStr), "%02lu/10/2026", 1 + i % 28);
+    snprintf(timeStr, sizeof(timeStr), "%02lu:%02lu:%02lu", i / 3600 % 24, i / 60 % 60, i % 60);
+    doc["id"] = "00c0ffee";
+    doc["date"] = dateStr;
+    doc["time"] = timeStr;
+
+    char horaLigar[6] = "08:00";
+    char horaDesligar[6] = "18:00";
+    doc["temperatura"] = 20.0f + (i % 100) / 10.0f;
+    doc["humidade"] = 40.0f + (i % 300) / 10.0f;
+    doc["luminosidade"] = (int)(i % 4096);
+    doc["hora_ligar"] = horaLigar;
+    doc["hora_desligar"] = horaDesligar;
+    doc["luz_maxima"] = 80;
+    doc["pwm"] = (int)(i % 256);
+    doc["intervalo_dht"] = 2000;
+    doc["intervalo_ldr"] = 250;
+
+    if (doc.overflowed())
+        return 0;
+    size_t len = serializeJson(doc, out, size);
+    return len < size ? len : 0;
+}
+
+// --- Orçamento do firmware (ESP32, ponteiros de 32 bits) ---
+
+// ARENA_SIZE do DashboardServer.h
+static const size_t DEVICE_ARENA_SIZE = 4096;
+// ArduinoJson 7 no ESP32: cada pool tem 128 slots de 8 bytes, alocados de uma vez
+static const size_t DEVICE_POOL_SIZE = 128 * 8;
+// Cabeçalho de cada bloco do RequestArena no ESP32 (dois size_t de 4 bytes)
+static const size_t DEVICE_HEADER_SIZE = 8;
+
+/**
+ * Arena que cobra de cada alocação o que ela custaria no ESP32 e recusa o
+ * que passaria de DEVICE_ARENA_SIZE, como o arena de 4 KB do firmware.
+ * Pools (as únicas alocações de 1 KB ou mais aqui) custam DEVICE_POOL_SIZE;
+ * o resto (textos) custa o mesmo tamanho que no PC, o que superestima o
+ * ESP32. Liberações não devolvem nada: o custo contado é um teto.
+ */
+class DeviceBudgetArena : public RequestArena
+{
+public:
+    DeviceBudgetArena(uint8_t *buffer, size_t capacity) : RequestArena(buffer, capacity) {}
+
+    void *allocate(size_t size) override
+    {
+        return charge(size) ? RequestArena::allocate(size) : nullptr;
+    }
+
+    void *reallocate(void *ptr, size_t new_size) override
+    {
+        return charge(new_size) ? RequestArena::reallocate(ptr, new_size) : nullptr;
+    }
+
+    void resetBudget()
+    {
+        reset();
+        _deviceUsed = 0;
+        _pools = 0;
+    }
+
+    size_t deviceUsed() const { return _deviceUsed; }
+    size_t devicePeak() const { return _devicePeak; }
+    size_t pools() const { return _pools; }
+
+private:
+    bool charge(size_t size)
+    {
+        bool pool = size >= DEVICE_POOL_SIZE;
+        size_t cost = (pool ? DEVICE_POOL_SIZE : (size + 7) & ~(size_t)7) + DEVICE_HEADER_SIZE;
+        if (_deviceUsed + cost > DEVICE_ARENA_SIZE)
+            return false;
+        _deviceUsed += cost;
+        _pools += pool;
+        if (_deviceUsed > _devicePeak)
+            _devicePeak = _deviceUsed;
+        return true;
+    }
+
+    size_t _deviceUsed = 0;
+    size_t _devicePeak = 0;
+    size_t _pools = 0;
+};
+
+void setUp() {}
+void tearDown() {}
+
+void test_allocate_is_aligned_and_bounded()
+{
+    uint8_t buffer[256];
+    RequestArena arena(buffer, sizeof(buffer));
+
+    void *a = arena.allocate(3);
+    void *b = arena.allocate(5);
+    TEST_ASSERT_NOT_NULL(a);
+    TEST_ASSERT_NOT_NULL(b);
+    TEST_ASSERT_EQUAL(0, ((uintptr_t)b - (uintptr_t)a) % 8);
+
+    // Não cabe: nullptr, e o arena continua usável
+    size_t before = arena.used();
+    TEST_ASSERT_NULL(arena.allocate(1000));
+    TEST_ASSERT_EQUAL(before, arena.used());
+
+    arena.reset();
+    TEST_ASSERT_EQUAL(0, arena.used());
+    TEST_ASSERT_TRUE(arena.peak() >= before);
+}
+
+void test_last_block_is_reused()
+{
+    uint8_t buffer[256];
+    RequestArena arena(buffer, sizeof(buffer));
+
+    void *a = arena.allocate(16);
+    size_t afterA = arena.used();
+    void *b = arena.allocate(32);
+
+    // Crescer o último bloco não move
+    TEST_ASSERT_TRUE(arena.reallocate(b, 64) == b);
+
+    // Devolver o último bloco libera o espaço; um bloco do meio espera o reset()
+    arena.deallocate(b);
+    TEST_ASSERT_EQUAL(afterA, arena.used());
+    void *c = arena.allocate(8);
+    TEST_ASSERT_TRUE(c == b);
+    arena.deallocate(a);
+    TEST_ASSERT_TRUE(arena.used() > afterA);
+
+    // Crescer um bloco do meio copia o conteúdo
+    memset(a, 0x5A, 16);
+    uint8_t *moved = (uint8_t *)arena.reallocate(a, 48);
+    TEST_ASSERT_NOT_NULL(moved);
+    TEST_ASSERT_TRUE(moved != a);
+    TEST_ASSERT_EQUAL_UINT8(0x5A, moved[15]);
+}
+
+void test_overflow_marks_document_without_heap()
+{
+    uint8_t buffer[64];
+    RequestArena arena(buffer, sizeof(buffer));
+
+    size_t before = heapAllocations;
+    size_t heapBefore = heapInUse();
+    {
+        JsonDocument doc(&arena);
+        for (int i = 0; i < 32; i++)
+            doc["campo"][i] = "um texto que nao cabe no arena";
+        TEST_ASSERT_TRUE(doc.overflowed());
+    }
+    TEST_ASSERT_EQUAL(before, heapAllocations);
+    TEST_ASSERT_EQUAL(heapBefore, heapInUse());
+}
+
+void test_soak_data_json()
+{
+    RequestArena arena(arenaBuffer, sizeof(arenaBuffer));
+    char out[512];
+
+    // Aquecimento: o pico da primeira requisição é a referência
+    TEST_ASSERT_TRUE(renderData(arena, 0, out, sizeof(out)) > 0);
+    arena.reset();
+    size_t firstPeak = arena.peak();
+
+    size_t newBefore = heapAllocations;
+    size_t heapBefore = heapInUse();
+
+    for (unsigned long i = 1; i <= REQUESTS; i++)
+    {
+        size_t len = renderData(arena, i, out, sizeof(out));
+        if (len == 0)
+        {
+            TEST_ASSERT_TRUE_MESSAGE(false, "Resposta nao coube no arena");
+            return;
+        }
+        arena.reset();
+        if (arena.used() != 0)
+        {
+            TEST_ASSERT_TRUE_MESSAGE(false, "Arena nao voltou a zero");
+            return;
+        }
+    }
+
+    size_t newAfter = heapAllocations;
+    size_t heapAfter = heapInUse();
+
+    char message[160];
+    snprintf(message, sizeof(message),
+             "%lu requisicoes: pico do arena %zu/%zu B (1a: %zu B), new: %zu, heap em uso %zu -> %zu B",
+             REQUESTS, arena.peak(), arena.capacity(), firstPeak, newAfter - newBefore, heapBefore, heapAfter);
+    TEST_MESSAGE(message);
+
+    TEST_ASSERT_EQUAL(newBefore, newAfter);
+    TEST_ASSERT_EQUAL(heapBefore, heapAfter);
+    // O pico só varia com o tamanho dos textos, não com o número de requisições
+    TEST_ASSERT_TRUE(arena.peak() <= firstPeak + 64);
+}
+
+// O /data.json do firmware cabe no arena de 4 KB contado como no ESP32
+void test_firmware_arena_budget()
+{
+    static uint8_t buffer[4 * DEVICE_ARENA_SIZE]; // Espaço real no PC; o limite é o orçamento
+    DeviceBudgetArena arena(buffer, sizeof(buffer));
+    char out[512];
+
+    size_t maxPools = 0;
+    for (unsigned long i = 0; i < 20000; i++)
+    {
+        if (renderData(arena, i, out, sizeof(out)) == 0)
+        {
+            char message[96];
+            snprintf(message, sizeof(message), "Requisicao %lu passou de %zu B contados como no ESP32",
+                     i, DEVICE_ARENA_SIZE);
+            TEST_ASSERT_TRUE_MESSAGE(false, message);
+            return;
+        }
+        if (arena.pools() > maxPools)
+            maxPools = arena.pools();
+        arena.resetBudget();
+    }
+
+    char message[128];
+    snprintf(message, sizeof(message), "ESP32: pico %zu/%zu B do arena, %zu pool(s) de %zu B",
+             arena.devicePeak(), DEVICE_ARENA_SIZE, maxPools, DEVICE_POOL_SIZE);
+    TEST_MESSAGE(message);
+
+    // Folga para o documento crescer: ao menos um pool livre
+    TEST_ASSERT_TRUE(arena.devicePeak() + DEVICE_POOL_SIZE + DEVICE_HEADER_SIZE <= DEVICE_ARENA_SIZE);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_allocate_is_aligned_and_bounded);
+    RUN_TEST(test_last_block_is_reused);
+    RUN_TEST(test_overflow_marks_document_without_heap);
+    RUN_TEST(test_soak_data_json);
+    RUN_TEST(test_firmware_arena_budget);
+    return UNITY_END();
+}
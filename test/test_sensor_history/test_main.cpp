@@ -0,0 +1,326 @@
+// Testes do SensorHistory no PC: pio test -e native
+//
+// Compara a árvore de segmentos com uma varredura simples de todas as
+// amostras, e confere que faixas e passos extremos (vindos da URL) não
+// estouram o time_t nem geram laços sem fim.
+
+#include <unity.h>
+
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <map>
+#include <random>
+
+#include "SensorHistory.h"
+
+static const time_t START = 1760000000; // Out/2025, depois do MIN_VALID_TIME
+
+// Modelo de referência: por canal, a média de cada intervalo e min/max das amostras
+struct Bucket
+{
+    int32_t sum[HISTORY_CHANNELS] = {};
+    int16_t min[HISTORY_CHANNELS];
+    int16_t max[HISTORY_CHANNELS];
+    int32_t samples[HISTORY_CHANNELS] = {};
+};
+
+struct Reference
+{
+    std::map<int64_t, Bucket> buckets;
+    int64_t lastBucket = -1;
+
+    Bucket *open(time_t when)
+    {
+        int64_t bucket = when / HISTORY_BUCKET_SECONDS;
+        if (bucket < lastBucket)
+            return nullptr;
+        lastBucket = bucket;
+        return &buckets[bucket];
+    }
+
+    static void add(Bucket &b, int c, int16_t value)
+    {
+        if (b.samples[c] == 0 || value < b.min[c])
+            b.min[c] = value;
+        if (b.samples[c] == 0 || value > b.max[c])
+            b.max[c] = value;
+        b.sum[c] += value;
+        b.samples[c]++;
+    }
+
+    void appendClimate(time_t when, float temperature, float humidity)
+    {
+        Bucket *b = open(when);
+        if (b == nullptr)
+            return;
+        if (!std::isnan(temperature))
+            add(*b, HISTORY_TEMPERATURE, (int16_t)lroundf(temperature * 10));
+        if (!std::isnan(humidity))
+            add(*b, HISTORY_HUMIDITY, (int16_t)lroundf(humidity * 10));
+    }
+
+    void appendLight(time_t when, int luminosity)
+    {
+        Bucket *b = open(when);
+        if (b != nullptr)
+            add(*b, HISTORY_LUMINOSITY, (int16_t)luminosity);
+    }
+
+    bool query(int64_t from, int64_t to, HistoryNode &out) const
+    {
+        out.clear();
+        if (lastBucket < 0 || to < from)
+            return false;
+        for (const auto &kv : buckets)
+        {
+            int64_t bucket = kv.first;
+            if (bucket <= lastBucket - HISTORY_BUCKETS || bucket < from / HISTORY_BUCKET_SECONDS ||
+                bucket > to / HISTORY_BUCKET_SECONDS)
+                continue;
+            const Bucket &b = kv.second;
+            for (int c = 0; c < HISTORY_CHANNELS; c++)
+            {
+                if (b.samples[c] == 0)
+                    continue;
+                if (b.min[c] < out.min[c])
+                    out.min[c] = b.min[c];
+                if (b.max[c] > out.max[c])
+                    out.max[c] = b.max[c];
+                out.sum[c] += b.sum[c] / b.samples[c];
+                out.count[c]++;
+            }
+        }
+        return !out.empty();
+    }
+};
+
+static void assertSameNode(const HistoryNode &expected, const HistoryNode &actual)
+{
+    for (int c = 0; c < HISTORY_CHANNELS; c++)
+    {
+        TEST_ASSERT_EQUAL(expected.count[c], actual.count[c]);
+        if (expected.count[c] == 0)
+            continue;
+        TEST_ASSERT_EQUAL_INT16(expected.min[c], actual.min[c]);
+        TEST_ASSERT_EQUAL_INT16(expected.max[c], actual.max[c]);
+        TEST_ASSERT_EQUAL(expected.sum[c], actual.sum[c]);
+    }
+}
+
+// ~40 dias (mais que a janela): o DHT a cada 2-600 s, com algumas falhas
+// (NAN), e o LDR num ritmo próprio. Há buracos e algumas amostras fora de
+// ordem, que devem ser ignoradas.
+static void fill(SensorHistory &history, Reference &reference, uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    time_t climateAt = START;
+    time_t lightAt = START;
+    time_t end = START + 40 * 86400;
+    while (climateAt < end || lightAt < end)
+    {
+        bool climate = climateAt <= lightAt;
+        time_t &t = climate ? climateAt : lightAt;
+
+        time_t when = t;
+        if (rng() % 50 == 0)
+            when -= 2 * HISTORY_BUCKET_SECONDS; // Atrasada: ignorada pelos dois
+        if (climate)
+        {
+            float temperature = rng() % 20 == 0 ? NAN : -10.0f + (rng() % 500) / 10.0f;
+            float humidity = rng() % 20 == 0 ? NAN : (rng() % 1000) / 10.0f;
+            history.appendClimate(when, temperature, humidity);
+            reference.appendClimate(when, temperature, humidity);
+            t += 2 + rng() % 600;
+        }
+        else
+        {
+            int luminosity = rng() % 4096;
+            history.appendLight(when, luminosity);
+            reference.appendLight(when, luminosity);
+            t += 1 + rng() % 120;
+        }
+
+        if (rng() % 400 == 0)
+            t += (rng() % 48) * 3600; // Buraco de até 2 dias num dos sensores
+    }
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_query_matches_brute_force()
+{
+    SensorHistory history;
+    TEST_ASSERT_TRUE(history.begin());
+    Reference reference;
+    fill(history, reference, 1);
+
+    std::mt19937 rng(2);
+    int64_t lastTime = (reference.lastBucket + 1) * HISTORY_BUCKET_SECONDS;
+    for (int i = 0; i < 5000; i++)
+    {
+        // Faixas dentro, atravessando e fora da janela de 32 dias
+        int64_t from = lastTime - (int64_t)(rng() % (40 * 86400));
+        int64_t to = from + (int64_t)(rng() % (10 * 86400));
+        HistoryNode expected, actual;
+        bool expectedFound = reference.query(from, to, expected);
+        TEST_ASSERT_EQUAL(expectedFound, history.query((time_t)from, (time_t)to, actual));
+        assertSameNode(expected, actual);
+    }
+}
+
+void test_plan_points_match_brute_force()
+{
+    SensorHistory history;
+    TEST_ASSERT_TRUE(history.begin());
+    Reference reference;
+    fill(history, reference, 3);
+
+    std::mt19937 rng(4);
+    int64_t windowStart = (reference.lastBucket - HISTORY_BUCKETS + 1) * HISTORY_BUCKET_SECONDS;
+    int64_t windowEnd = (reference.lastBucket + 1) * HISTORY_BUCKET_SECONDS - 1;
+    for (int i = 0; i < 500; i++)
+    {
+        int64_t from = windowEnd - (int64_t)(rng() % (40 * 86400));
+        int64_t to = from + (int64_t)(rng() % (40 * 86400));
+        uint32_t step = 1 + rng() % (3 * 86400);
+
+        HistoryRange range;
+        TEST_ASSERT_TRUE(history.plan((time_t)from, (time_t)to, step, range));
+        TEST_ASSERT_TRUE(range.points <= HISTORY_MAX_POINTS);
+        if (range.points == 0)
+        {
+            TEST_ASSERT_TRUE(to < windowStart);
+            continue;
+        }
+        TEST_ASSERT_EQUAL(0, range.step % HISTORY_BUCKET_SECONDS);
+        TEST_ASSERT_TRUE(range.from >= windowStart);
+
+        // Os pontos cobrem [max(from, janela), min(to, janela)] sem sobrar ponto vazio no fim
+        int64_t last = to < windowEnd ? to : windowEnd;
+        TEST_ASSERT_TRUE(range.from + (int64_t)(range.points - 1) * range.step <= last);
+        TEST_ASSERT_TRUE(range.from + (int64_t)range.points * range.step > last);
+
+        for (uint32_t p = 0; p < range.points; p++)
+        {
+            int64_t t = range.from + (int64_t)p * range.step;
+            HistoryNode expected, actual;
+            reference.query(t, t + range.step - 1, expected);
+            history.query((time_t)t, (time_t)(t + range.step - 1), actual);
+            assertSameNode(expected, actual);
+        }
+    }
+}
+
+void test_plan_rejects_invalid_input()
+{
+    SensorHistory history;
+    TEST_ASSERT_TRUE(history.begin());
+    history.appendClimate(START, 20.0f, 50.0f);
+
+    HistoryRange range;
+    TEST_ASSERT_FALSE(history.plan(START, START + 3600, 0, range));
+    TEST_ASSERT_FALSE(history.plan(START + 1, START, 3600, range));
+    TEST_ASSERT_EQUAL(0, range.points);
+}
+
+// Limites do time_t de 32 bits do ESP32 e do de 64 bits do PC: antes o
+// laço 't += step' estourava e nunca terminava
+void test_plan_extreme_ranges_are_bounded()
+{
+    SensorHistory history;
+    TEST_ASSERT_TRUE(history.begin());
+    Reference reference;
+    fill(history, reference, 5);
+
+    const int64_t limits[][2] = {
+        {INT32_MIN, INT32_MAX},
+        {0, INT32_MAX},
+        {INT32_MAX - 10, INT32_MAX},
+        {(int64_t)START, INT32_MAX},
+        {INT64_MIN, INT64_MAX},
+        {INT64_MAX - 1, INT64_MAX},
+    };
+    const uint32_t steps[] = {1, 3600, 86400, UINT32_MAX};
+
+    for (const auto &limit : limits)
+    {
+        if (sizeof(time_t) < 8 && (limit[0] < INT32_MIN || limit[1] > INT32_MAX))
+            continue;
+        for (uint32_t step : steps)
+        {
+            HistoryRange range;
+            TEST_ASSERT_TRUE(history.plan((time_t)limit[0], (time_t)limit[1], step, range));
+            TEST_ASSERT_TRUE(range.points <= HISTORY_MAX_POINTS);
+
+            // O mesmo laço do writeJson(): termina e cada ponto é consultável
+            for (uint32_t p = 0; p < range.points; p++)
+            {
+                time_t t = range.from + (time_t)(p * range.step);
+                HistoryNode node;
+                history.query(t, t + (time_t)(range.step - 1), node);
+                TEST_ASSERT_TRUE(t + (time_t)(range.step - 1) > t);
+            }
+        }
+    }
+}
+
+// O LDR é lido bem mais vezes que o DHT: cada canal tem a sua média, e
+// um canal sem leituras no intervalo não entra na média dos outros
+void test_signals_have_separate_series()
+{
+    SensorHistory history;
+    TEST_ASSERT_TRUE(history.begin());
+
+    time_t hour = START - START % HISTORY_BUCKET_SECONDS;
+    history.appendClimate(hour + 10, 20.0f, 40.0f);
+    for (int i = 0; i < 1000; i++)
+        history.appendLight(hour + 10 + i, i < 500 ? 1000 : 3000);
+    history.appendClimate(hour + 1800, 30.0f, NAN); // Humidade falhou
+
+    // Hora seguinte: só luz
+    for (int i = 0; i < 10; i++)
+        history.appendLight(hour + HISTORY_BUCKET_SECONDS + i, 500);
+
+    HistoryNode node;
+    TEST_ASSERT_TRUE(history.query(hour, hour + HISTORY_BUCKET_SECONDS - 1, node));
+    TEST_ASSERT_EQUAL(250, node.sum[HISTORY_TEMPERATURE]); // (200 + 300) / 2 leituras
+    TEST_ASSERT_EQUAL(400, node.sum[HISTORY_HUMIDITY]);    // Só a leitura boa
+    TEST_ASSERT_EQUAL(2000, node.sum[HISTORY_LUMINOSITY]);
+
+    TEST_ASSERT_TRUE(history.query(hour, hour + 2 * HISTORY_BUCKET_SECONDS - 1, node));
+    TEST_ASSERT_EQUAL(1, node.count[HISTORY_TEMPERATURE]);
+    TEST_ASSERT_EQUAL(2, node.count[HISTORY_LUMINOSITY]);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 250.0f, node.average(HISTORY_TEMPERATURE));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 1250.0f, node.average(HISTORY_LUMINOSITY));
+}
+
+void test_empty_history()
+{
+    SensorHistory history;
+    TEST_ASSERT_TRUE(history.begin());
+
+    HistoryNode node;
+    TEST_ASSERT_FALSE(history.query(START, START + 86400, node));
+    HistoryRange range;
+    TEST_ASSERT_TRUE(history.plan(START, START + 86400, 3600, range));
+    TEST_ASSERT_EQUAL(0, range.points);
+
+    // Antes do NTP: ignorada
+    history.appendClimate(1000, 20.0f, 50.0f);
+    history.appendLight(1000, 100);
+    TEST_ASSERT_FALSE(history.query(0, INT32_MAX, node));
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_query_matches_brute_force);
+    RUN_TEST(test_plan_points_match_brute_force);
+    RUN_TEST(test_plan_rejects_invalid_input);
+    RUN_TEST(test_plan_extreme_ranges_are_bounded);
+    RUN_TEST(test_signals_have_separate_series);
+    RUN_TEST(test_empty_history);
+    return UNITY_END();
+}
@@ -0,0 +1,282 @@
+// Fila offline da telemetria (TelemetrySpool) no PC: pio test -e native
+//
+// Ponta a ponta com um broker simulado no próprio processo: lotes são
+// publicados, o broker cai, os lotes vão para a fila, o broker volta e a
+// fila é drenada como o loop() do TelemetryPublisher drena (um lote por
+// volta, com lotes novos chegando no meio). Confere que o broker recebe
+// todos os lotes, sem repetir nenhum, na ordem em que foram gerados.
+
+#include <unity.h>
+
+#include <cstring>
+#include <map>
+#include <vector>
+
+#include "TelemetrySpool.h"
+
+static const size_t MAX_PAYLOAD = 1536; // TELEMETRY_MAX_PAYLOAD
+
+// Broker: guarda o número de sequência de cada lote recebido
+struct FakeBroker
+{
+    bool up = true;
+    std::vector<uint32_t> received;
+};
+
+static bool brokerPublish(void *ctx, const uint8_t *payload, size_t len)
+{
+    FakeBroker *broker = (FakeBroker *)ctx;
+    if (!broker->up || len < 4)
+        return false;
+    uint32_t sequence;
+    memcpy(&sequence, payload, sizeof(sequence));
+    broker->received.push_back(sequence);
+    return true;
+}
+
+// Armazenamento em memória (a NVS do ESP32); sobrevive a um "reinício"
+struct MemoryStore
+{
+    std::map<uint32_t, std::vector<uint8_t>> entries;
+    unsigned long writes = 0;
+    bool failWrites = false;
+};
+
+static bool storePut(void *ctx, uint32_t index, const uint8_t *data, size_t len)
+{
+    MemoryStore *store = (MemoryStore *)ctx;
+    if (store->failWrites)
+        return false;
+    store->entries[index].assign(data, data + len);
+    store->writes++;
+    return true;
+}
+
+static size_t storeGet(void *ctx, uint32_t index, uint8_t *data, size_t size)
+{
+    MemoryStore *store = (MemoryStore *)ctx;
+    auto it = store->entries.find(index);
+    if (it == store->entries.end() || it->second.size() > size)
+        return 0;
+    memcpy(data, it->second.data(), it->second.size());
+    return it->second.size();
+}
+
+static void storeRemove(void *ctx, uint32_t index)
+{
+    ((MemoryStore *)ctx)->entries.erase(index);
+}
+
+static SpoolStore storeOf(MemoryStore &store)
+{
+    return SpoolStore{&store, storePut, storeGet, storeRemove};
+}
+
+// Lote com o número de sequência no começo e tamanho variável, como os
+// lotes em MessagePack (de algumas dezenas de bytes até quase o máximo)
+static std::vector<uint8_t> makeBatch(uint32_t sequence)
+{
+    std::vector<uint8_t> batch(32 + (sequence * 97) % (MAX_PAYLOAD - 32));
+    for (size_t i = 0; i < batch.size(); i++)
+        batch[i] = (uint8_t)(sequence + i);
+    memcpy(batch.data(), &sequence, sizeof(sequence));
+    return batch;
+}
+
+// Uma volta do loop() do TelemetryPublisher com o broker no ar
+static void drainStep(TelemetrySpool &spool)
+{
+    uint8_t buffer[MAX_PAYLOAD];
+    spool.drainOne(buffer, sizeof(buffer));
+}
+
+static void assertInOrder(const std::vector<uint32_t> &received, uint32_t first, uint32_t count)
+{
+    TEST_ASSERT_EQUAL_UINT32(count, received.size());
+    for (uint32_t i = 0; i < count; i++)
+        TEST_ASSERT_EQUAL_UINT32(first + i, received[i]);
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_online_publishes_without_flash_writes()
+{
+    FakeBroker broker;
+    MemoryStore store;
+    TelemetrySpool spool;
+    spool.begin(storeOf(store), 64, 0, 0, brokerPublish, &broker);
+
+    for (uint32_t sequence = 0; sequence < 100; sequence++)
+    {
+        std::vector<uint8_t> batch = makeBatch(sequence);
+        TEST_ASSERT_EQUAL(TelemetrySpool::PUBLISHED, spool.submit(batch.data(), batch.size()));
+    }
+    assertInOrder(broker.received, 0, 100);
+    TEST_ASSERT_EQUAL_UINT32(0, store.writes);
+}
+
+// Broker fora por 40 lotes; na volta, lotes novos continuam chegando
+// enquanto a fila drena e precisam entrar atrás dos antigos
+void test_outage_spools_and_drains_in_order()
+{
+    FakeBroker broker;
+    MemoryStore store;
+    TelemetrySpool spool;
+    spool.begin(storeOf(store), 64, 0, 0, brokerPublish, &broker);
+
+    uint32_t sequence = 0;
+    for (; sequence < 10; sequence++)
+    {
+        std::vector<uint8_t> batch = makeBatch(sequence);
+        spool.submit(batch.data(), batch.size());
+    }
+
+    broker.up = false;
+    for (; sequence < 50; sequence++)
+    {
+        std::vector<uint8_t> batch = makeBatch(sequence);
+        TEST_ASSERT_EQUAL(TelemetrySpool::QUEUED, spool.submit(batch.data(), batch.size()));
+        drainStep(spool); // Falha e deixa o lote na fila
+    }
+    TEST_ASSERT_EQUAL_UINT32(40, spool.pending());
+    TEST_ASSERT_EQUAL_UINT32(10, broker.received.size());
+
+    broker.up = true;
+    for (int step = 0; !spool.empty(); step++)
+    {
+        if (step % 3 == 0)
+        {
+            std::vector<uint8_t> batch = makeBatch(sequence++);
+            TEST_ASSERT_EQUAL(TelemetrySpool::QUEUED, spool.submit(batch.data(), batch.size()));
+        }
+        drainStep(spool);
+        TEST_ASSERT_TRUE(step < 1000);
+    }
+
+    // Fila vazia: o próximo lote volta a ir direto
+    std::vector<uint8_t> batch = makeBatch(sequence++);
+    TEST_ASSERT_EQUAL(TelemetrySpool::PUBLISHED, spool.submit(batch.data(), batch.size()));
+
+    assertInOrder(broker.received, 0, sequence);
+    TEST_ASSERT_TRUE(store.entries.empty());
+}
+
+// O broker cai de novo no meio da drenagem: nada se perde nem se repete
+void test_broker_flaps_during_drain()
+{
+    FakeBroker broker;
+    MemoryStore store;
+    TelemetrySpool spool;
+    spool.begin(storeOf(store), 64, 0, 0, brokerPublish, &broker);
+
+    broker.up = false;
+    uint32_t sequence = 0;
+    for (; sequence < 30; sequence++)
+    {
+        std::vector<uint8_t> batch = makeBatch(sequence);
+        spool.submit(batch.data(), batch.size());
+    }
+
+    for (int step = 0; !spool.empty(); step++)
+    {
+        broker.up = (step / 4) % 2 == 1; // 4 voltas fora, 4 no ar
+        drainStep(spool);
+        if (step % 5 == 0)
+        {
+            std::vector<uint8_t> batch = makeBatch(sequence++);
+            spool.submit(batch.data(), batch.size());
+        }
+        TEST_ASSERT_TRUE(step < 1000);
+    }
+    assertInOrder(broker.received, 0, sequence);
+}
+
+// Fila cheia: os mais antigos são descartados, os que ficam saem em ordem
+void test_full_spool_evicts_oldest()
+{
+    FakeBroker broker;
+    MemoryStore store;
+    TelemetrySpool spool;
+    spool.begin(storeOf(store), 8, 0, 0, brokerPublish, &broker);
+
+    broker.up = false;
+    for (uint32_t sequence = 0; sequence < 20; sequence++)
+    {
+        std::vector<uint8_t> batch = makeBatch(sequence);
+        TelemetrySpool::Result result = spool.submit(batch.data(), batch.size());
+        TEST_ASSERT_EQUAL(sequence < 8 ? TelemetrySpool::QUEUED : TelemetrySpool::QUEUED_EVICTED, result);
+    }
+    TEST_ASSERT_EQUAL_UINT32(8, spool.pending());
+    TEST_ASSERT_EQUAL_UINT32(12, spool.evicted());
+    TEST_ASSERT_EQUAL(8, store.entries.size());
+
+    broker.up = true;
+    while (!spool.empty())
+        drainStep(spool);
+    assertInOrder(broker.received, 12, 8);
+}
+
+// Reinício com lotes na flash: o dono refaz cabeça/cauda e a fila continua
+void test_reboot_resumes_queue()
+{
+    FakeBroker broker;
+    MemoryStore store;
+    {
+        TelemetrySpool spool;
+        spool.begin(storeOf(store), 64, 0, 0, brokerPublish, &broker);
+        broker.up = false;
+        for (uint32_t sequence = 0; sequence < 12; sequence++)
+        {
+            std::vector<uint8_t> batch = makeBatch(sequence);
+            spool.submit(batch.data(), batch.size());
+        }
+        broker.up = true;
+        for (int i = 0; i < 5; i++)
+            drainStep(spool);
+    }
+
+    // Como o openSpool() faz: menor índice gravado e o seguinte ao maior
+    uint32_t head = store.entries.begin()->first;
+    uint32_t tail = store.entries.rbegin()->first + 1;
+    TelemetrySpool spool;
+    spool.begin(storeOf(store), 64, head, tail, brokerPublish, &broker);
+    TEST_ASSERT_EQUAL_UINT32(7, spool.pending());
+
+    std::vector<uint8_t> batch = makeBatch(12);
+    TEST_ASSERT_EQUAL(TelemetrySpool::QUEUED, spool.submit(batch.data(), batch.size()));
+    while (!spool.empty())
+        drainStep(spool);
+    assertInOrder(broker.received, 0, 13);
+}
+
+void test_without_storage_batches_are_dropped()
+{
+    FakeBroker broker;
+    MemoryStore store;
+    TelemetrySpool spool;
+    spool.begin(storeOf(store), 0, 0, 0, brokerPublish, &broker);
+
+    broker.up = false;
+    std::vector<uint8_t> batch = makeBatch(0);
+    TEST_ASSERT_EQUAL(TelemetrySpool::DROPPED, spool.submit(batch.data(), batch.size()));
+    TEST_ASSERT_TRUE(spool.empty());
+
+    // Falha de escrita: o lote é perdido, mas a fila continua consistente
+    spool.begin(storeOf(store), 8, 0, 0, brokerPublish, &broker);
+    store.failWrites = true;
+    TEST_ASSERT_EQUAL(TelemetrySpool::STORE_FAILED, spool.submit(batch.data(), batch.size()));
+    TEST_ASSERT_TRUE(spool.empty());
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_online_publishes_without_flash_writes);
+    RUN_TEST(test_outage_spools_and_drains_in_order);
+    RUN_TEST(test_broker_flaps_during_drain);
+    RUN_TEST(test_full_spool_evicts_oldest);
+    RUN_TEST(test_reboot_resumes_queue);
+    RUN_TEST(test_without_storage_batches_are_dropped);
+    return UNITY_END();
+}
@@ -0,0 +1,129 @@
+// Escuta os beacons de status (TelemetryBeacon) na rede local e imprime
+// uma linha por pacote, contando perdas por dispositivo.
+//
+// Compilação (Linux, na raiz do repositório):
+//   g++ -O2 -std=c++17 -I lib/TelemetryBeacon tools/beacon_listener/beacon_listener.cpp -o beacon_listener
+//
+// Uso:
+//   ./beacon_listener [grupo] [porta]      (padrão 239.255.42.99 5099)
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <unordered_map>
+
+#include "BeaconPacket.h"
+
+static const char *DEFAULT_GROUP = "239.255.42.99";
+static const uint16_t DEFAULT_PORT = 5099;
+
+struct DeviceStats
+{
+    uint32_t lastSequence;
+    uint64_t received;
+    uint64_t lost;
+};
+
+int main(int argc, char **argv)
+{
+    const char *group = argc > 1 ? argv[1] : DEFAULT_GROUP;
+    uint16_t port = argc > 2 ? (uint16_t)atoi(argv[2]) : DEFAULT_PORT;
+
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd < 0)
+    {
+        perror("socket");
+        return 1;
+    }
+
+    // Permite vários ouvintes na mesma máquina
+    int yes = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    if (bind(fd, (sockaddr *)&addr, sizeof(addr)) < 0)
+    {
+        perror("bind");
+        return 1;
+    }
+
+    ip_mreq mreq = {};
+    if (inet_pton(AF_INET, group, &mreq.imr_multiaddr) != 1)
+    {
+        fprintf(stderr, "Grupo multicast invalido: %s\n", group);
+        return 1;
+    }
+    mreq.imr_interface.s_addr = htonl(INADDR_ANY);
+    if (setsockopt(fd, IPPROTO_IP, IP_ADD_MEMBERSHIP, &mreq, sizeof(mreq)) < 0)
+    {
+        perror("IP_ADD_MEMBERSHIP");
+        return 1;
+    }
+
+    printf("Escutando %s:%u\n", group, port);
+
+    std::unordered_map<uint32_t, DeviceStats> devices;
+    uint8_t buffer[512];
+
+    for (;;)
+    {
+        sockaddr_in from = {};
+        socklen_t fromLen = sizeof(from);
+        ssize_t len = recvfrom(fd, buffer, sizeof(buffer), 0, (sockaddr *)&from, &fromLen);
+        if (len < 0)
+        {
+            perror("recvfrom");
+            continue;
+        }
+
+        BeaconStatus status;
+        if (!beaconDecode(buffer, (size_t)len, status))
+            continue;
+
+        // Perdas: buracos na sequência. Sequência menor = dispositivo reiniciou.
+        auto it = devices.find(status.deviceId);
+        if (it == devices.end())
+        {
+            it = devices.emplace(status.deviceId, DeviceStats{status.sequence, 0, 0}).first;
+        }
+        else if (status.sequence > it->second.lastSequence)
+        {
+            it->second.lost += status.sequence - it->second.lastSequence - 1;
+        }
+        it->second.lastSequence = status.sequence;
+        it->second.received++;
+
+        char ip[INET_ADDRSTRLEN];
+        inet_ntop(AF_INET, &from.sin_addr, ip, sizeof(ip));
+
+        char temperature[16] = "--";
+        char humidity[16] = "--";
+        if (status.temperature != BEACON_NO_TEMPERATURE)
+            snprintf(temperature, sizeof(temperature), "%.1f", status.temperature / 10.0);
+        if (status.humidity != BEACON_NO_HUMIDITY)
+            snprintf(humidity, sizeof(humidity), "%.1f", status.humidity / 10.0);
+
+        time_t now = time(nullptr);
+        char stamp[16];
+        strftime(stamp, sizeof(stamp), "%H:%M:%S", localtime(&now));
+
+        printf("%s %-15s %08x seq=%u up=%us T=%sC H=%s%% L=%u pwm=%u %02u:%02u-%02u:%02u max=%u%%%s%s perdidos=%llu\n",
+               stamp, ip, (unsigned)status.deviceId, (unsigned)status.sequence, (unsigned)status.uptime,
+               temperature, humidity, status.luminosity, status.pwm,
+               status.onMinutes / 60, status.onMinutes % 60, status.offMinutes / 60, status.offMinutes % 60,
+               status.maxLight,
+               (status.flags & BEACON_FLAG_CHANGE) ? " [mudanca]" : "",
+               (status.flags & BEACON_FLAG_TIME_SYNC) ? "" : " [sem NTP]",
+               (unsigned long long)it->second.lost);
+        fflush(stdout);
+    }
+}
@@ -0,0 +1,93 @@
+// Envia beacons de status de teste (mesmo formato do TelemetryBeacon), para
+// conferir o beacon_listener e o fleet_collector sem uma placa na rede.
+// Pula alguns números de sequência de propósito: o ouvinte deve contá-los
+// como perdidos.
+//
+// Compilação (Linux, na raiz do repositório):
+//   g++ -O2 -std=c++17 -I lib/TelemetryBeacon tools/beacon_listener/beacon_sender.cpp -o beacon_sender
+//
+// Uso:
+//   ./beacon_sender [grupo] [porta] [pacotes] [pular a cada]   (padrão 239.255.42.99 5099 10 4)
+//
+// Com o ouvinte na mesma máquina, o multicast volta pelo loopback.
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstdlib>
+
+#include "BeaconPacket.h"
+
+static const char *DEFAULT_GROUP = "239.255.42.99";
+static const uint16_t DEFAULT_PORT = 5099;
+static const uint32_t DEVICE_ID = 0x00C0FFEE; // Não colide com um MAC de ESP32
+
+int main(int argc, char **argv)
+{
+    const char *group = argc > 1 ? argv[1] : DEFAULT_GROUP;
+    uint16_t port = argc > 2 ? (uint16_t)atoi(argv[2]) : DEFAULT_PORT;
+    uint32_t count = argc > 3 ? (uint32_t)strtoul(argv[3], nullptr, 10) : 10;
+    uint32_t skipEvery = argc > 4 ? (uint32_t)strtoul(argv[4], nullptr, 10) : 4;
+
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd < 0)
+    {
+        perror("socket");
+        return 1;
+    }
+
+    // Entrega também para ouvintes nesta máquina
+    unsigned char loop = 1;
+    setsockopt(fd, IPPROTO_IP, IP_MULTICAST_LOOP, &loop, sizeof(loop));
+
+    sockaddr_in to = {};
+    to.sin_family = AF_INET;
+    to.sin_port = htons(port);
+    if (inet_pton(AF_INET, group, &to.sin_addr) != 1)
+    {
+        fprintf(stderr, "Grupo multicast invalido: %s\n", group);
+        return 1;
+    }
+
+    uint32_t sent = 0;
+    uint32_t skipped = 0;
+    for (uint32_t sequence = 0; sequence < count; sequence++)
+    {
+        // Nunca pula o primeiro: é ele que registra o dispositivo no ouvinte
+        if (skipEvery > 0 && sequence > 0 && sequence % skipEvery == 0)
+        {
+            skipped++;
+            continue;
+        }
+
+        BeaconStatus status = {};
+        status.flags = (sequence % 3 == 0 ? BEACON_FLAG_CHANGE : 0) | BEACON_FLAG_TIME_SYNC;
+        status.deviceId = DEVICE_ID;
+        status.sequence = sequence;
+        status.uptime = sequence * 10;
+        status.temperature = sequence % 5 == 4 ? BEACON_NO_TEMPERATURE : (int16_t)(215 + sequence % 10);
+        status.humidity = (uint16_t)(550 + sequence % 20);
+        status.luminosity = (uint16_t)(sequence * 97 % 4096);
+        status.pwm = (uint16_t)(sequence * 13 % 256);
+        status.onMinutes = 6 * 60 + 30;
+        status.offMinutes = 22 * 60;
+        status.maxLight = 80;
+
+        uint8_t packet[BEACON_PACKET_SIZE];
+        size_t len = beaconEncode(status, packet, sizeof(packet));
+        if (sendto(fd, packet, len, 0, (sockaddr *)&to, sizeof(to)) != (ssize_t)len)
+        {
+            perror("sendto");
+            return 1;
+        }
+        sent++;
+        usleep(50000);
+    }
+
+    printf("%u pacotes enviados para %s:%u como %08x, %u pulados\n", sent, group, port, DEVICE_ID, skipped);
+    close(fd);
+    return 0;
+}
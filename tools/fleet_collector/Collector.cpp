@@ -0,0 +1,516 @@
+#include "Collector.h"
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/tcp.h>
+#include <strings.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+
+#include "BeaconPacket.h"
+#include "JsonScan.h"
+
+static const size_t RESPONSE_BUFFER_SIZE = 2048; // /data.json tem ~250 bytes
+static const size_t MAX_EVENTS = 256;
+
+// Marca o socket dos beacons no epoll (as conexões usam o ponteiro)
+static int BEACON_TAG;
+
+struct Collector::Connection
+{
+    int fd;
+    size_t device;
+    bool connected;
+    uint64_t startNs;
+    size_t length;
+    char buffer[RESPONSE_BUFFER_SIZE];
+};
+
+static uint64_t nowNs()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/**
+ * @brief Converte "HH:MM" para minutos (0 se inválido).
+ */
+static uint16_t minutesOf(std::string_view hh_mm)
+{
+    if (hh_mm.size() != 5 || hh_mm[2] != ':')
+        return 0;
+    return ((hh_mm[0] - '0') * 10 + (hh_mm[1] - '0')) * 60 + (hh_mm[3] - '0') * 10 + (hh_mm[4] - '0');
+}
+
+/**
+ * @brief Lê o "id" do /data.json: 8 dígitos hexadecimais.
+ */
+static bool parseDeviceId(std::string_view text, uint32_t &id)
+{
+    if (text.size() != 8)
+        return false;
+    id = 0;
+    for (char ch : text)
+    {
+        uint32_t digit;
+        if (ch >= '0' && ch <= '9')
+            digit = ch - '0';
+        else if (ch >= 'a' && ch <= 'f')
+            digit = ch - 'a' + 10;
+        else if (ch >= 'A' && ch <= 'F')
+            digit = ch - 'A' + 10;
+        else
+            return false;
+        id = (id << 4) | digit;
+    }
+    return true;
+}
+
+/**
+ * @brief Nome da série de um dispositivo, igual pelo polling e pelo beacon.
+ */
+static std::string deviceKey(uint32_t id)
+{
+    char name[16];
+    snprintf(name, sizeof(name), "esp-%08x", (unsigned)id);
+    return name;
+}
+
+/**
+ * @brief Acha o corpo de uma resposta HTTP 200.
+ * @param eof true se o dispositivo já fechou a conexão.
+ * @param complete Recebe true quando o corpo chegou inteiro.
+ * @return false se a resposta é inválida, não é 200 ou foi cortada.
+ */
+static bool httpBody(std::string_view response, bool eof, std::string_view &body, bool &complete)
+{
+    complete = false;
+    size_t headerEnd = response.find("\r\n\r\n");
+    if (headerEnd == std::string_view::npos)
+        return eof ? false : true;
+
+    std::string_view header = response.substr(0, headerEnd);
+    if (header.size() < 12 || header.substr(0, 5) != "HTTP/" || header.substr(9, 3) != "200")
+        return false;
+
+    body = response.substr(headerEnd + 4);
+
+    // O WebServer do ESP32 manda Content-Length; sem ele, o corpo vai até o fim da conexão
+    size_t pos = 0;
+    while ((pos = header.find("\r\n", pos)) != std::string_view::npos)
+    {
+        pos += 2;
+        std::string_view line = header.substr(pos, header.find("\r\n", pos) - pos);
+        if (line.size() > 15 && strncasecmp(line.data(), "Content-Length:", 15) == 0)
+        {
+            std::string_view value = line.substr(15);
+            while (!value.empty() && value.front() == ' ')
+                value.remove_prefix(1);
+            int64_t length;
+            if (!JsonScan::toInt(value, length) || length < 0)
+                return false;
+            if (body.size() < (size_t)length)
+                return eof ? false : true;
+            body = body.substr(0, (size_t)length);
+            complete = true;
+            return true;
+        }
+    }
+
+    complete = eof;
+    return true;
+}
+
+Collector::Collector(SeriesStore &store) : _store(store)
+{
+    _epoll = epoll_create1(EPOLL_CLOEXEC);
+    _beaconFd = -1;
+    _pollIntervalMs = 10000;
+    _timeoutMs = 2000;
+    _maxInFlight = 256;
+    _recordLatency = false;
+}
+
+Collector::~Collector()
+{
+    for (Connection *conn : _inFlight)
+    {
+        close(conn->fd);
+        delete conn;
+    }
+    for (Connection *conn : _free)
+        delete conn;
+    if (_beaconFd >= 0)
+        close(_beaconFd);
+    close(_epoll);
+}
+
+bool Collector::addDevice(const char *hostPort)
+{
+    std::string host(hostPort);
+    uint16_t port = 80;
+    size_t colon = host.find(':');
+    if (colon != std::string::npos)
+    {
+        port = (uint16_t)atoi(host.c_str() + colon + 1);
+        host.resize(colon);
+    }
+
+    Device device = {};
+    device.addr.sin_family = AF_INET;
+    device.addr.sin_port = htons(port);
+    if (inet_pton(AF_INET, host.c_str(), &device.addr.sin_addr) != 1 || port == 0)
+    {
+        fprintf(stderr, "[Collector] Endereco invalido: %s\n", hostPort);
+        return false;
+    }
+
+    // A série só é criada na primeira resposta, quando o id é conhecido
+    device.name = host + ":" + std::to_string(port);
+    device.slot = -1;
+    device.nextPollNs = 0;
+
+    _queue.push_back(_devices.size());
+    _devices.push_back(device);
+    return true;
+}
+
+bool Collector::subscribeBeacon(const char *group, uint16_t port)
+{
+    int fd = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0)
+        return false;
+
+    int yes = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+
+    ip_mreq mreq = {};
+    mreq.imr_interface.s_addr = htonl(INADDR_ANY);
+
+    if (inet_pton(AF_INET, group, &mreq.imr_multiaddr) != 1 ||
+        bind(fd, (sockaddr *)&addr, sizeof(addr)) < 0 ||
+        setsockopt(fd, IPPROTO_IP, IP_ADD_MEMBERSHIP, &mreq, sizeof(mreq)) < 0)
+    {
+        fprintf(stderr, "[Collector] Erro ao entrar no grupo %s:%u: %s\n", group, port, strerror(errno));
+        close(fd);
+        return false;
+    }
+
+    epoll_event ev = {};
+    ev.events = EPOLLIN;
+    ev.data.ptr = &BEACON_TAG;
+    epoll_ctl(_epoll, EPOLL_CTL_ADD, fd, &ev);
+
+    _beaconFd = fd;
+    return true;
+}
+
+void Collector::run(volatile sig_atomic_t &stop, unsigned long durationMs)
+{
+    uint64_t deadline = durationMs > 0 ? nowNs() + durationMs * 1000000ULL : UINT64_MAX;
+    epoll_event events[MAX_EVENTS];
+
+    while (!stop)
+    {
+        uint64_t now = nowNs();
+        if (now >= deadline)
+            break;
+
+        startDue(now);
+
+        // Dorme até o próximo polling, o próximo timeout ou o fim
+        uint64_t wake = deadline;
+        if (!_queue.empty() && _inFlight.size() < _maxInFlight)
+            wake = std::min<uint64_t>(wake, _devices[_queue.front()].nextPollNs);
+        for (Connection *conn : _inFlight)
+            wake = std::min<uint64_t>(wake, conn->startNs + _timeoutMs * 1000000ULL);
+
+        int timeoutMs = wake > now ? (int)std::min<uint64_t>((wake - now + 999999) / 1000000, 1000) : 0;
+        int count = epoll_wait(_epoll, events, MAX_EVENTS, timeoutMs);
+
+        now = nowNs();
+        for (int i = 0; i < count; i++)
+        {
+            if (events[i].data.ptr == &BEACON_TAG)
+                onBeacon();
+            else
+                onConnectionEvent((Connection *)events[i].data.ptr, events[i].events, now);
+        }
+
+        // Timeouts (iteração de trás para frente: finish() remove da lista)
+        for (size_t i = _inFlight.size(); i-- > 0;)
+        {
+            if (now - _inFlight[i]->startNs >= _timeoutMs * 1000000ULL)
+                finish(_inFlight[i], false, now);
+        }
+    }
+}
+
+// --- Funções Privadas ---
+
+void Collector::startDue(uint64_t now)
+{
+    while (!_queue.empty() && _inFlight.size() < _maxInFlight)
+    {
+        size_t device = _queue.front();
+        if (_devices[device].nextPollNs > now)
+            break;
+        _queue.pop_front();
+
+        if (!startPoll(device, now))
+        {
+            _stats.failures++;
+            _devices[device].nextPollNs = now + _pollIntervalMs * 1000000ULL;
+            _queue.push_back(device);
+        }
+    }
+}
+
+bool Collector::startPoll(size_t device, uint64_t now)
+{
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0)
+        return false;
+
+    int yes = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+
+    const Device &d = _devices[device];
+    if (connect(fd, (const sockaddr *)&d.addr, sizeof(d.addr)) < 0 && errno != EINPROGRESS)
+    {
+        close(fd);
+        return false;
+    }
+
+    Connection *conn;
+    if (_free.empty())
+    {
+        conn = new Connection;
+    }
+    else
+    {
+        conn = _free.back();
+        _free.pop_back();
+    }
+    conn->fd = fd;
+    conn->device = device;
+    conn->connected = false;
+    conn->startNs = now;
+    conn->length = 0;
+
+    // Pronto para escrever = conectado
+    epoll_event ev = {};
+    ev.events = EPOLLOUT;
+    ev.data.ptr = conn;
+    epoll_ctl(_epoll, EPOLL_CTL_ADD, fd, &ev);
+
+    _inFlight.push_back(conn);
+    return true;
+}
+
+void Collector::onConnectionEvent(Connection *conn, uint32_t events, uint64_t now)
+{
+    if (!conn->connected)
+    {
+        int error = 0;
+        socklen_t len = sizeof(error);
+        getsockopt(conn->fd, SOL_SOCKET, SO_ERROR, &error, &len);
+        if (error != 0 || (events & (EPOLLERR | EPOLLHUP)))
+        {
+            finish(conn, false, now);
+            return;
+        }
+
+        // A requisição cabe no buffer do socket: um send() basta
+        static const char REQUEST[] = "GET /data.json HTTP/1.1\r\nHost: pld\r\nConnection: close\r\n\r\n";
+        if (send(conn->fd, REQUEST, sizeof(REQUEST) - 1, MSG_NOSIGNAL) != (ssize_t)sizeof(REQUEST) - 1)
+        {
+            finish(conn, false, now);
+            return;
+        }
+
+        conn->connected = true;
+        epoll_event ev = {};
+        ev.events = EPOLLIN | EPOLLRDHUP;
+        ev.data.ptr = conn;
+        epoll_ctl(_epoll, EPOLL_CTL_MOD, conn->fd, &ev);
+        return;
+    }
+
+    bool eof = false;
+    for (;;)
+    {
+        size_t room = RESPONSE_BUFFER_SIZE - conn->length;
+        if (room == 0)
+        {
+            finish(conn, false, now); // Resposta grande demais para ser o /data.json
+            return;
+        }
+        ssize_t n = recv(conn->fd, conn->buffer + conn->length, room, 0);
+        if (n > 0)
+        {
+            conn->length += n;
+            continue;
+        }
+        if (n == 0)
+            eof = true;
+        else if (errno != EAGAIN && errno != EWOULDBLOCK)
+            eof = true;
+        break;
+    }
+
+    std::string_view body;
+    bool complete;
+    if (!httpBody(std::string_view(conn->buffer, conn->length), eof, body, complete))
+    {
+        finish(conn, false, now);
+        return;
+    }
+    if (complete)
+        finish(conn, storeResponse(conn->device, body), now);
+    else if (eof)
+        finish(conn, false, now);
+}
+
+void Collector::finish(Connection *conn, bool ok, uint64_t now)
+{
+    epoll_ctl(_epoll, EPOLL_CTL_DEL, conn->fd, nullptr);
+    close(conn->fd);
+
+    if (ok)
+    {
+        _stats.polls++;
+        if (_recordLatency)
+            _stats.latencyUs.push_back((uint32_t)((nowNs() - conn->startNs) / 1000));
+    }
+    else
+    {
+        _stats.failures++;
+    }
+
+    Device &d = _devices[conn->device];
+    d.nextPollNs = conn->startNs + _pollIntervalMs * 1000000ULL;
+    if (d.nextPollNs < now && _pollIntervalMs > 0)
+        d.nextPollNs = now;
+    _queue.push_back(conn->device);
+
+    for (size_t i = 0; i < _inFlight.size(); i++)
+    {
+        if (_inFlight[i] == conn)
+        {
+            _inFlight[i] = _inFlight.back();
+            _inFlight.pop_back();
+            break;
+        }
+    }
+    _free.push_back(conn);
+}
+
+bool Collector::storeResponse(size_t device, std::string_view body)
+{
+    Sample sample = {};
+    sample.time = (uint32_t)time(nullptr);
+    sample.temperature = SAMPLE_NO_TEMPERATURE;
+    sample.humidity = SAMPLE_NO_HUMIDITY;
+
+    // Os campos são lidos direto do buffer da resposta, sem cópia
+    JsonScan scan(body);
+    std::string_view key, value;
+    bool isString;
+    int fields = 0;
+    uint32_t id = 0;
+    bool hasId = false;
+    while (scan.next(key, value, isString))
+    {
+        double number;
+        if (isString)
+        {
+            if (key == "id")
+                hasId = parseDeviceId(value, id);
+            else if (key == "hora_ligar")
+                sample.onMinutes = minutesOf(value), fields++;
+            else if (key == "hora_desligar")
+                sample.offMinutes = minutesOf(value), fields++;
+            continue;
+        }
+        if (!JsonScan::toDouble(value, number))
+            continue; // null (sensor sem leitura) ou campo que não é número
+
+        if (key == "temperatura")
+            sample.temperature = (int16_t)lround(number * 10), fields++;
+        else if (key == "humidade")
+            sample.humidity = (uint16_t)lround(number * 10), fields++;
+        else if (key == "luminosidade")
+            sample.luminosity = (uint16_t)number, fields++;
+        else if (key == "pwm")
+            sample.pwm = (uint16_t)number;
+        else if (key == "luz_maxima")
+            sample.maxLight = (uint8_t)number, fields++;
+    }
+
+    // Sem nenhum campo conhecido não é um /data.json
+    if (fields == 0)
+        return false;
+
+    // Mesma série do beacon do dispositivo. Firmware antigo (sem "id")
+    // fica na série do endereço. O id é conferido a cada resposta: outra
+    // placa pode assumir o mesmo IP.
+    Device &d = _devices[device];
+    std::string seriesKey = hasId ? deviceKey(id) : d.name;
+    if (d.slot < 0 || seriesKey != d.key)
+    {
+        int slot = _store.device(seriesKey);
+        if (slot < 0)
+        {
+            fprintf(stderr, "[Collector] Arquivo de series cheio, ignorando %s\n", seriesKey.c_str());
+            return false;
+        }
+        d.slot = slot;
+        d.key = seriesKey;
+    }
+
+    _store.append(d.slot, sample);
+    return true;
+}
+
+void Collector::onBeacon()
+{
+    uint8_t packet[512];
+    ssize_t len;
+    while ((len = recv(_beaconFd, packet, sizeof(packet), 0)) > 0)
+    {
+        BeaconStatus status;
+        if (!beaconDecode(packet, (size_t)len, status))
+            continue;
+
+        int slot = _store.device(deviceKey(status.deviceId));
+        if (slot < 0)
+            continue;
+
+        Sample sample;
+        sample.time = (uint32_t)time(nullptr);
+        sample.temperature = status.temperature == BEACON_NO_TEMPERATURE ? SAMPLE_NO_TEMPERATURE : status.temperature;
+        sample.humidity = status.humidity == BEACON_NO_HUMIDITY ? SAMPLE_NO_HUMIDITY : status.humidity;
+        sample.luminosity = status.luminosity;
+        sample.pwm = status.pwm;
+        sample.onMinutes = status.onMinutes;
+        sample.offMinutes = status.offMinutes;
+        sample.maxLight = status.maxLight;
+        _store.append(slot, sample);
+        _stats.beacons++;
+    }
+}
@@ -0,0 +1,94 @@
+#ifndef COLLECTOR_H
+#define COLLECTOR_H
+
+// Coleta o status de muitos dispositivos ao mesmo tempo num único
+// thread, com epoll:
+//  - GET /data.json em cada dispositivo cadastrado (TCP não bloqueante,
+//    até 'maxInFlight' conexões abertas);
+//  - beacons UDP multicast (TelemetryBeacon), se inscrito.
+// Cada resposta vira uma linha no SeriesStore, na série do id do
+// dispositivo ("esp-<id>"): o mesmo id vem no /data.json e no beacon.
+
+#include <netinet/in.h>
+
+#include <csignal>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "SeriesStore.h"
+
+struct CollectorStats
+{
+    uint64_t polls = 0;    // Respostas HTTP gravadas
+    uint64_t failures = 0; // Conexão recusada, timeout, resposta inválida
+    uint64_t beacons = 0;  // Beacons UDP gravados
+    std::vector<uint32_t> latencyUs; // Início do GET até a linha gravada (só com recordLatency)
+};
+
+class Collector
+{
+public:
+    explicit Collector(SeriesStore &store);
+    ~Collector();
+
+    /**
+     * @brief Cadastra um dispositivo para o polling de /data.json.
+     * @param hostPort "IP" ou "IP:porta" (porta 80 por padrão).
+     */
+    bool addDevice(const char *hostPort);
+
+    /**
+     * @brief Entra no grupo multicast dos beacons.
+     */
+    bool subscribeBeacon(const char *group, uint16_t port);
+
+    void setPollInterval(unsigned long ms) { _pollIntervalMs = ms; }
+    void setMaxInFlight(size_t count) { _maxInFlight = count; }
+    void setTimeout(unsigned long ms) { _timeoutMs = ms; }
+    void setRecordLatency(bool record) { _recordLatency = record; }
+
+    /**
+     * @brief Roda até 'stop' ficar != 0 ou, se durationMs > 0, até o tempo acabar.
+     */
+    void run(volatile sig_atomic_t &stop, unsigned long durationMs = 0);
+
+    const CollectorStats &stats() const { return _stats; }
+    size_t deviceCount() const { return _devices.size(); }
+
+private:
+    struct Device
+    {
+        std::string name; // "IP:porta": a linha enquanto a resposta não trouxer o "id"
+        std::string key;  // Nome da linha no SeriesStore ("esp-<id>" ou name)
+        sockaddr_in addr;
+        int slot;         // -1 até a primeira resposta
+        uint64_t nextPollNs;
+    };
+
+    struct Connection;
+
+    void startDue(uint64_t now);
+    bool startPoll(size_t device, uint64_t now);
+    void onConnectionEvent(Connection *conn, uint32_t events, uint64_t now);
+    void finish(Connection *conn, bool ok, uint64_t now);
+    bool storeResponse(size_t device, std::string_view body);
+    void onBeacon();
+
+    SeriesStore &_store;
+    int _epoll;
+    int _beaconFd;
+    std::vector<Device> _devices;
+    std::deque<size_t> _queue; // Ordem do próximo polling (todos com o mesmo intervalo)
+    std::vector<Connection *> _inFlight;
+    std::vector<Connection *> _free;
+    unsigned long _pollIntervalMs;
+    unsigned long _timeoutMs;
+    size_t _maxInFlight;
+    bool _recordLatency;
+    CollectorStats _stats;
+};
+
+#endif // COLLECTOR_H
@@ -0,0 +1,150 @@
+#include "DeviceSimulator.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+// Nos eventos do epoll: listeners têm o bit alto, conexões guardam o fd
+static const uint64_t LISTENER_BIT = 1ULL << 63;
+
+// Ids dos dispositivos simulados ("id" do /data.json): base + índice
+static const uint32_t SIMULATED_ID_BASE = 0x51A00000;
+
+DeviceSimulator::DeviceSimulator()
+{
+    _epoll = -1;
+    _running = false;
+}
+
+DeviceSimulator::~DeviceSimulator()
+{
+    stop();
+}
+
+bool DeviceSimulator::start(size_t count)
+{
+    _epoll = epoll_create1(EPOLL_CLOEXEC);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (fd < 0)
+        {
+            fprintf(stderr, "[Sim] Erro no socket %zu: %s\n", i, strerror(errno));
+            stop();
+            return false;
+        }
+
+        sockaddr_in addr = {};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = 0; // Porta livre qualquer
+        socklen_t len = sizeof(addr);
+        if (bind(fd, (sockaddr *)&addr, sizeof(addr)) < 0 || listen(fd, 64) < 0 ||
+            getsockname(fd, (sockaddr *)&addr, &len) < 0)
+        {
+            fprintf(stderr, "[Sim] Erro ao abrir porta %zu: %s\n", i, strerror(errno));
+            close(fd);
+            stop();
+            return false;
+        }
+
+        epoll_event ev = {};
+        ev.events = EPOLLIN;
+        ev.data.u64 = LISTENER_BIT | i;
+        epoll_ctl(_epoll, EPOLL_CTL_ADD, fd, &ev);
+
+        _listeners.push_back(fd);
+        _ports.push_back(ntohs(addr.sin_port));
+    }
+    _served.assign(count, 0);
+
+    _running = true;
+    _thread = std::thread(&DeviceSimulator::run, this);
+    return true;
+}
+
+void DeviceSimulator::stop()
+{
+    _running = false;
+    if (_thread.joinable())
+        _thread.join();
+
+    for (int fd : _listeners)
+        close(fd);
+    _listeners.clear();
+    _ports.clear();
+    if (_epoll >= 0)
+        close(_epoll);
+    _epoll = -1;
+}
+
+// --- Funções Privadas ---
+
+void DeviceSimulator::run()
+{
+    epoll_event events[256];
+    std::vector<size_t> owner; // fd da conexão -> dispositivo
+
+    while (_running)
+    {
+        int count = epoll_wait(_epoll, events, 256, 50);
+        for (int i = 0; i < count; i++)
+        {
+            uint64_t tag = events[i].data.u64;
+            if (tag & LISTENER_BIT)
+            {
+                size_t device = (size_t)(tag & ~LISTENER_BIT);
+                int fd;
+                while ((fd = accept4(_listeners[device], nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0)
+                {
+                    if ((size_t)fd >= owner.size())
+                        owner.resize(fd + 1);
+                    owner[fd] = device;
+
+                    epoll_event ev = {};
+                    ev.events = EPOLLIN;
+                    ev.data.u64 = (uint64_t)fd;
+                    epoll_ctl(_epoll, EPOLL_CTL_ADD, fd, &ev);
+                }
+                continue;
+            }
+
+            // A requisição do coletor chega num segmento só
+            int fd = (int)tag;
+            char request[512];
+            ssize_t n = recv(fd, request, sizeof(request), 0);
+            if (n > 0)
+                respond(fd, owner[fd]);
+            epoll_ctl(_epoll, EPOLL_CTL_DEL, fd, nullptr);
+            close(fd);
+        }
+    }
+}
+
+void DeviceSimulator::respond(int fd, size_t device)
+{
+    // Valores variam por dispositivo e por requisição, como sensores reais
+    uint32_t k = _served[device]++;
+    char body[256];
+    int bodyLen = snprintf(body, sizeof(body),
+                           "{\"id\":\"%08x\",\"temperatura\":%.1f,\"humidade\":%.1f,\"luminosidade\":%u,"
+                           "\"hora_ligar\":\"06:30\",\"hora_desligar\":\"22:00\",\"luz_maxima\":%u,"
+                           "\"pwm\":%u,\"intervalo_dht\":2000,\"intervalo_ldr\":250}",
+                           (unsigned)(SIMULATED_ID_BASE + device), 20.0 + (device % 100) / 10.0 + (k % 7) / 10.0, 55.0 + (k % 11) / 10.0,
+                           (unsigned)((device * 37 + k) % 4096), (unsigned)(device % 101),
+                           (unsigned)((device + k) % 256));
+
+    char response[512];
+    int len = snprintf(response, sizeof(response),
+                       "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\n"
+                       "Content-Length: %d\r\nConnection: close\r\n\r\n%s",
+                       bodyLen, body);
+    send(fd, response, len, MSG_NOSIGNAL);
+}
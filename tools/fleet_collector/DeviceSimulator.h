@@ -0,0 +1,41 @@
+#ifndef DEVICE_SIMULATOR_H
+#define DEVICE_SIMULATOR_H
+
+// Dispositivos simulados para o benchmark: N portas TCP em 127.0.0.1,
+// cada uma responde GET /data.json como o DashboardServer do firmware
+// (mesmos campos, Content-Length e Connection: close). Roda num thread
+// próprio com epoll.
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+class DeviceSimulator
+{
+public:
+    DeviceSimulator();
+    ~DeviceSimulator();
+
+    /**
+     * @brief Abre 'count' portas e começa a responder.
+     * @return false se não conseguiu abrir as portas (limite de arquivos?).
+     */
+    bool start(size_t count);
+    void stop();
+
+    const std::vector<uint16_t> &ports() const { return _ports; }
+
+private:
+    void run();
+    void respond(int fd, size_t device);
+
+    int _epoll;
+    std::vector<int> _listeners;
+    std::vector<uint16_t> _ports;
+    std::vector<uint32_t> _served;
+    std::thread _thread;
+    std::atomic<bool> _running;
+};
+
+#endif // DEVICE_SIMULATOR_H
@@ -0,0 +1,140 @@
+#ifndef JSON_SCAN_H
+#define JSON_SCAN_H
+
+// Leitor JSON sem cópia para objetos planos como o do /data.json:
+// percorre o buffer uma vez e devolve chave e valor como string_view
+// apontando para o próprio buffer. Não aloca nem decodifica escapes
+// (as chaves e os valores do firmware não têm).
+
+#include <charconv>
+#include <cstdint>
+#include <string_view>
+
+class JsonScan
+{
+public:
+    explicit JsonScan(std::string_view text) : _p(text.data()), _end(text.data() + text.size())
+    {
+        skipSpace();
+        _ok = _p < _end && *_p == '{';
+        if (_ok)
+            _p++;
+    }
+
+    /**
+     * @brief Avança para o próximo par chave/valor do objeto.
+     * @param value Token bruto: string sem as aspas, número, true/false/null
+     *              ou o texto inteiro de um objeto/array aninhado.
+     * @return false no fim do objeto ou se o JSON for inválido.
+     */
+    bool next(std::string_view &key, std::string_view &value, bool &isString)
+    {
+        if (!_ok)
+            return false;
+
+        skipSpace();
+        if (_p < _end && *_p == ',')
+        {
+            _p++;
+            skipSpace();
+        }
+        if (_p >= _end || *_p != '"')
+            return _ok = false; // '}' ou lixo
+
+        if (!readString(key))
+            return _ok = false;
+
+        skipSpace();
+        if (_p >= _end || *_p != ':')
+            return _ok = false;
+        _p++;
+        skipSpace();
+        if (_p >= _end)
+            return _ok = false;
+
+        isString = *_p == '"';
+        if (isString)
+            return _ok = readString(value);
+
+        const char *start = _p;
+        if (*_p == '{' || *_p == '[')
+        {
+            if (!skipNested())
+                return _ok = false;
+        }
+        else
+        {
+            while (_p < _end && *_p != ',' && *_p != '}' && !isSpace(*_p))
+                _p++;
+        }
+        value = std::string_view(start, _p - start);
+        return !value.empty();
+    }
+
+    static bool toDouble(std::string_view token, double &out)
+    {
+        auto result = std::from_chars(token.data(), token.data() + token.size(), out);
+        return result.ec == std::errc() && result.ptr == token.data() + token.size();
+    }
+
+    static bool toInt(std::string_view token, int64_t &out)
+    {
+        auto result = std::from_chars(token.data(), token.data() + token.size(), out);
+        return result.ec == std::errc() && result.ptr == token.data() + token.size();
+    }
+
+private:
+    static bool isSpace(char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\n'; }
+
+    void skipSpace()
+    {
+        while (_p < _end && isSpace(*_p))
+            _p++;
+    }
+
+    // _p em '"'. Devolve o conteúdo sem as aspas.
+    bool readString(std::string_view &out)
+    {
+        const char *start = ++_p;
+        while (_p < _end && *_p != '"')
+        {
+            if (*_p == '\\')
+                _p++;
+            _p++;
+        }
+        if (_p >= _end)
+            return false;
+        out = std::string_view(start, _p - start);
+        _p++;
+        return true;
+    }
+
+    // _p em '{' ou '['. Pula até o fechamento correspondente.
+    bool skipNested()
+    {
+        int depth = 0;
+        while (_p < _end)
+        {
+            char c = *_p;
+            if (c == '"')
+            {
+                std::string_view ignored;
+                if (!readString(ignored))
+                    return false;
+                continue;
+            }
+            _p++;
+            if (c == '{' || c == '[')
+                depth++;
+            else if ((c == '}' || c == ']') && --depth == 0)
+                return true;
+        }
+        return false;
+    }
+
+    const char *_p;
+    const char *_end;
+    bool _ok;
+};
+
+#endif // JSON_SCAN_H
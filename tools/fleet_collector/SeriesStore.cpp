@@ -0,0 +1,291 @@
+#include "SeriesStore.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+static const uint32_t STORE_MAGIC = 0x53444C50; // "PLDS"
+static const uint32_t STORE_VERSION = 1;
+
+// Início de cada coluna dentro do bloco, em múltiplos de 'capacity'
+enum Column
+{
+    COL_TIME = 0,         // u32
+    COL_TEMPERATURE = 4,  // i16
+    COL_HUMIDITY = 6,     // u16
+    COL_LUMINOSITY = 8,   // u16
+    COL_PWM = 10,         // u16
+    COL_ON = 12,          // u16
+    COL_OFF = 14,         // u16
+    COL_MAX_LIGHT = 16,   // u8
+    COL_END = 17,
+};
+
+struct SeriesStore::Header
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t maxDevices;
+    uint32_t capacity;
+    uint32_t deviceCount;
+    uint8_t reserved[44];
+};
+
+struct SeriesStore::DirEntry
+{
+    char name[NAME_SIZE];
+    uint64_t rows;     // Total de linhas já gravadas (a posição no anel é rows % capacity)
+    uint32_t lastTime; // Tempo da linha mais nova
+    uint8_t reserved[12];
+};
+
+static size_t blockSizeFor(uint32_t capacity)
+{
+    size_t size = (size_t)capacity * COL_END;
+    return (size + 63) & ~(size_t)63;
+}
+
+SeriesStore::SeriesStore()
+{
+    _fd = -1;
+    _map = nullptr;
+    _size = 0;
+    _header = nullptr;
+    _blockSize = 0;
+}
+
+SeriesStore::~SeriesStore()
+{
+    close();
+}
+
+bool SeriesStore::open(const char *path, uint32_t maxDevices, uint32_t capacity)
+{
+    static_assert(sizeof(Header) == 64, "cabecalho de 64 bytes");
+    static_assert(sizeof(DirEntry) == 64, "entrada de diretorio de 64 bytes");
+
+    close();
+
+    _fd = ::open(path, O_RDWR | O_CREAT, 0644);
+    if (_fd < 0)
+    {
+        fprintf(stderr, "[Store] Erro ao abrir %s: %s\n", path, strerror(errno));
+        return false;
+    }
+
+    struct stat st;
+    fstat(_fd, &st);
+    bool fresh = st.st_size == 0;
+
+    if (!fresh)
+    {
+        // Arquivo existente: a geometria vem do cabeçalho
+        Header header;
+        if (pread(_fd, &header, sizeof(header), 0) != (ssize_t)sizeof(header) ||
+            header.magic != STORE_MAGIC || header.version != STORE_VERSION)
+        {
+            fprintf(stderr, "[Store] %s nao e um arquivo de series valido.\n", path);
+            close();
+            return false;
+        }
+        maxDevices = header.maxDevices;
+        capacity = header.capacity;
+    }
+
+    _blockSize = blockSizeFor(capacity);
+    _size = sizeof(Header) + (size_t)maxDevices * sizeof(DirEntry) + (size_t)maxDevices * _blockSize;
+
+    if (fresh && ftruncate(_fd, _size) != 0)
+    {
+        fprintf(stderr, "[Store] Erro ao criar %s: %s\n", path, strerror(errno));
+        close();
+        return false;
+    }
+    if (!fresh && (size_t)st.st_size < _size)
+    {
+        fprintf(stderr, "[Store] %s esta truncado.\n", path);
+        close();
+        return false;
+    }
+
+    void *map = mmap(nullptr, _size, PROT_READ | PROT_WRITE, MAP_SHARED, _fd, 0);
+    if (map == MAP_FAILED)
+    {
+        fprintf(stderr, "[Store] Erro no mmap: %s\n", strerror(errno));
+        close();
+        return false;
+    }
+    _map = (uint8_t *)map;
+    _header = (Header *)_map;
+
+    if (fresh)
+    {
+        _header->magic = STORE_MAGIC;
+        _header->version = STORE_VERSION;
+        _header->maxDevices = maxDevices;
+        _header->capacity = capacity;
+        _header->deviceCount = 0;
+    }
+
+    // Reconstrói o índice nome -> slot
+    _index.clear();
+    for (uint32_t i = 0; i < _header->deviceCount; i++)
+    {
+        _index.emplace(std::string(deviceName(i)), (int)i);
+    }
+    return true;
+}
+
+void SeriesStore::close()
+{
+    if (_map != nullptr)
+    {
+        msync(_map, _size, MS_SYNC);
+        munmap(_map, _size);
+    }
+    if (_fd >= 0)
+        ::close(_fd);
+
+    _fd = -1;
+    _map = nullptr;
+    _header = nullptr;
+    _size = 0;
+    _index.clear();
+}
+
+int SeriesStore::device(std::string_view name)
+{
+    if (name.size() >= NAME_SIZE)
+        name = name.substr(0, NAME_SIZE - 1);
+
+    auto it = _index.find(std::string(name));
+    if (it != _index.end())
+        return it->second;
+
+    if (_header->deviceCount >= _header->maxDevices)
+        return -1;
+
+    int slot = (int)_header->deviceCount;
+    DirEntry *e = entry(slot);
+    memset(e, 0, sizeof(*e));
+    memcpy(e->name, name.data(), name.size());
+    _header->deviceCount++;
+
+    _index.emplace(std::string(name), slot);
+    return slot;
+}
+
+void SeriesStore::append(int slot, const Sample &sample)
+{
+    DirEntry *e = entry(slot);
+    uint8_t *b = block(slot);
+    uint32_t capacity = _header->capacity;
+    uint32_t i = (uint32_t)(e->rows % capacity);
+
+    // A busca por tempo assume a coluna ordenada: um relógio que volta
+    // (ajuste de hora no coletor) repete o último tempo
+    uint32_t time = sample.time < e->lastTime ? e->lastTime : sample.time;
+
+    ((uint32_t *)(b + COL_TIME * capacity))[i] = time;
+    ((int16_t *)(b + COL_TEMPERATURE * capacity))[i] = sample.temperature;
+    ((uint16_t *)(b + COL_HUMIDITY * capacity))[i] = sample.humidity;
+    ((uint16_t *)(b + COL_LUMINOSITY * capacity))[i] = sample.luminosity;
+    ((uint16_t *)(b + COL_PWM * capacity))[i] = sample.pwm;
+    ((uint16_t *)(b + COL_ON * capacity))[i] = sample.onMinutes;
+    ((uint16_t *)(b + COL_OFF * capacity))[i] = sample.offMinutes;
+    (b + COL_MAX_LIGHT * capacity)[i] = sample.maxLight;
+
+    e->lastTime = time;
+    e->rows++;
+}
+
+size_t SeriesStore::query(int slot, uint32_t from, uint32_t to, Sample *out, size_t max) const
+{
+    uint64_t rows = entry(slot)->rows;
+    size_t count = 0;
+    for (uint64_t row = lowerBound(slot, from); row < rows && count < max; row++)
+    {
+        Sample sample = readRow(slot, row);
+        if (sample.time > to)
+            break;
+        out[count++] = sample;
+    }
+    return count;
+}
+
+uint32_t SeriesStore::deviceCount() const
+{
+    return _header ? _header->deviceCount : 0;
+}
+
+std::string_view SeriesStore::deviceName(int slot) const
+{
+    const DirEntry *e = entry(slot);
+    return std::string_view(e->name, strnlen(e->name, NAME_SIZE));
+}
+
+uint64_t SeriesStore::rowCount(int slot) const
+{
+    return entry(slot)->rows;
+}
+
+void SeriesStore::sync()
+{
+    if (_map != nullptr)
+        msync(_map, _size, MS_ASYNC);
+}
+
+// --- Funções Privadas ---
+
+SeriesStore::DirEntry *SeriesStore::entry(int slot) const
+{
+    return (DirEntry *)(_map + sizeof(Header)) + slot;
+}
+
+uint8_t *SeriesStore::block(int slot) const
+{
+    return _map + sizeof(Header) + (size_t)_header->maxDevices * sizeof(DirEntry) + (size_t)slot * _blockSize;
+}
+
+Sample SeriesStore::readRow(int slot, uint64_t row) const
+{
+    const uint8_t *b = block(slot);
+    uint32_t capacity = _header->capacity;
+    uint32_t i = (uint32_t)(row % capacity);
+
+    Sample sample;
+    sample.time = ((const uint32_t *)(b + COL_TIME * capacity))[i];
+    sample.temperature = ((const int16_t *)(b + COL_TEMPERATURE * capacity))[i];
+    sample.humidity = ((const uint16_t *)(b + COL_HUMIDITY * capacity))[i];
+    sample.luminosity = ((const uint16_t *)(b + COL_LUMINOSITY * capacity))[i];
+    sample.pwm = ((const uint16_t *)(b + COL_PWM * capacity))[i];
+    sample.onMinutes = ((const uint16_t *)(b + COL_ON * capacity))[i];
+    sample.offMinutes = ((const uint16_t *)(b + COL_OFF * capacity))[i];
+    sample.maxLight = (b + COL_MAX_LIGHT * capacity)[i];
+    return sample;
+}
+
+// Primeira linha (lógica) com time >= 'time', por busca binária na coluna de tempo
+uint64_t SeriesStore::lowerBound(int slot, uint32_t time) const
+{
+    uint64_t rows = entry(slot)->rows;
+    uint32_t capacity = _header->capacity;
+    const uint32_t *times = (const uint32_t *)(block(slot) + COL_TIME * capacity);
+
+    uint64_t lo = rows > capacity ? rows - capacity : 0;
+    uint64_t hi = rows;
+    while (lo < hi)
+    {
+        uint64_t mid = lo + (hi - lo) / 2;
+        if (times[mid % capacity] < time)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
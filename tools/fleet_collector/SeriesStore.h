@@ -0,0 +1,94 @@
+#ifndef SERIES_STORE_H
+#define SERIES_STORE_H
+
+// Arquivo de séries temporais colunar, mapeado em memória (mmap).
+//
+// Layout:
+//   [cabeçalho 64 B][diretório: maxDevices x 64 B][blocos de dados]
+//
+// Cada dispositivo tem um bloco próprio com 'capacity' linhas em anel,
+// guardadas coluna por coluna (todos os tempos, depois todas as
+// temperaturas, ...). Uma consulta a um campo de um dispositivo lê só
+// aquela coluna, em memória contígua. O diretório é o índice por
+// dispositivo: nome, total de linhas gravadas e o intervalo de tempo.
+//
+// Todos os inteiros são little-endian (o formato nativo do x86/ARM Linux).
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+struct Sample
+{
+    uint32_t time;        // Unix (s)
+    int16_t temperature;  // x10 (C), SAMPLE_NO_TEMPERATURE sem leitura
+    uint16_t humidity;    // x10 (%), SAMPLE_NO_HUMIDITY sem leitura
+    uint16_t luminosity;  // 0-4095
+    uint16_t pwm;
+    uint16_t onMinutes;   // hora_ligar em minutos
+    uint16_t offMinutes;  // hora_desligar em minutos
+    uint8_t maxLight;     // luz_maxima (%)
+};
+
+static const int16_t SAMPLE_NO_TEMPERATURE = INT16_MIN;
+static const uint16_t SAMPLE_NO_HUMIDITY = UINT16_MAX;
+
+class SeriesStore
+{
+public:
+    static const size_t NAME_SIZE = 40;
+
+    SeriesStore();
+    ~SeriesStore();
+
+    /**
+     * @brief Abre o arquivo ou cria um novo com o tamanho dado.
+     * Um arquivo existente mantém a geometria com que foi criado.
+     * @return false em erro (mensagem em stderr).
+     */
+    bool open(const char *path, uint32_t maxDevices, uint32_t capacity);
+    void close();
+
+    /**
+     * @brief Índice do dispositivo no diretório, criando a entrada se preciso.
+     * @return -1 se o diretório estiver cheio.
+     */
+    int device(std::string_view name);
+
+    void append(int slot, const Sample &sample);
+
+    /**
+     * @brief Lê as linhas com time em [from, to], em ordem.
+     * @return Quantidade escrita em 'out' (no máximo 'max').
+     */
+    size_t query(int slot, uint32_t from, uint32_t to, Sample *out, size_t max) const;
+
+    uint32_t deviceCount() const;
+    std::string_view deviceName(int slot) const;
+    uint64_t rowCount(int slot) const;
+
+    /**
+     * @brief Grava as páginas sujas no disco (msync).
+     */
+    void sync();
+
+private:
+    struct Header;
+    struct DirEntry;
+
+    DirEntry *entry(int slot) const;
+    uint8_t *block(int slot) const;
+    Sample readRow(int slot, uint64_t row) const;
+    uint64_t lowerBound(int slot, uint32_t time) const;
+
+    int _fd;
+    uint8_t *_map;
+    size_t _size;
+    Header *_header;
+    size_t _blockSize;
+    std::unordered_map<std::string, int> _index;
+};
+
+#endif // SERIES_STORE_H
@@ -0,0 +1,331 @@
+// Coletor da frota: lê o status de muitos controladores (GET /data.json
+// e/ou beacons UDP) e grava num arquivo de séries temporais colunar.
+//
+// Compilação (Linux, na raiz do repositório):
+//   g++ -O2 -std=c++17 -pthread -I lib/TelemetryBeacon tools/fleet_collector/*.cpp -o fleet_collector
+//
+// Uso:
+//   fleet_collector [opções] --device 192.168.0.21 --device 192.168.0.22:8080 ...
+//     --store ARQ        Arquivo de séries (padrão fleet.pld)
+//     --devices ARQ      Lista de dispositivos, um "IP[:porta]" por linha
+//     --beacon           Grava também os beacons multicast (239.255.42.99:5099)
+//     --interval MS      Intervalo do polling por dispositivo (padrão 10000)
+//     --max-conn N       Conexões simultâneas (padrão 256)
+//     --capacity N       Linhas por dispositivo ao criar o arquivo (padrão 8640)
+//     --max-devices N    Dispositivos ao criar o arquivo (padrão 1024)
+//
+//   fleet_collector --store ARQ --dump [DISPOSITIVO]
+//     Lista os dispositivos, ou as últimas 24 h de um deles em CSV.
+//
+//   fleet_collector --bench N [--seconds S] [--max-conn N]
+//     Benchmark contra N dispositivos simulados em 127.0.0.1: mede
+//     dispositivos/s e a latência de ingestão (GET até a linha gravada).
+
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <vector>
+
+#include "Collector.h"
+#include "DeviceSimulator.h"
+#include "SeriesStore.h"
+
+static const char *BEACON_GROUP = "239.255.42.99"; // Mesmo grupo/porta do firmware (main.cpp)
+static const uint16_t BEACON_PORT = 5099;
+static const unsigned long STATS_INTERVAL = 10000;
+
+static volatile sig_atomic_t stopRequested = 0;
+
+static void onSignal(int)
+{
+    stopRequested = 1;
+}
+
+struct Options
+{
+    const char *store = "fleet.pld";
+    std::vector<std::string> devices;
+    bool beacon = false;
+    unsigned long interval = 10000;
+    size_t maxConn = 256;
+    uint32_t capacity = 8640; // 24 h a cada 10 s
+    uint32_t maxDevices = 1024;
+    bool dump = false;
+    const char *dumpDevice = nullptr;
+    size_t bench = 0;
+    unsigned long seconds = 10;
+};
+
+static void usage()
+{
+    fprintf(stderr,
+            "Uso: fleet_collector [--store ARQ] [--device IP[:PORTA]]... [--devices ARQ] [--beacon]\n"
+            "                     [--interval MS] [--max-conn N] [--capacity N] [--max-devices N]\n"
+            "     fleet_collector --store ARQ --dump [DISPOSITIVO]\n"
+            "     fleet_collector --bench N [--seconds S] [--max-conn N]\n");
+}
+
+static bool readDeviceList(const char *path, std::vector<std::string> &devices)
+{
+    FILE *f = fopen(path, "r");
+    if (f == nullptr)
+    {
+        perror(path);
+        return false;
+    }
+    char line[128];
+    while (fgets(line, sizeof(line), f))
+    {
+        line[strcspn(line, "\r\n#")] = '\0';
+        char *p = line;
+        while (*p == ' ' || *p == '\t')
+            p++;
+        if (*p)
+            devices.push_back(p);
+    }
+    fclose(f);
+    return true;
+}
+
+static bool parseArgs(int argc, char **argv, Options &opt)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        const char *arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (!strcmp(arg, "--store") && hasValue)
+            opt.store = argv[++i];
+        else if (!strcmp(arg, "--device") && hasValue)
+            opt.devices.push_back(argv[++i]);
+        else if (!strcmp(arg, "--devices") && hasValue)
+        {
+            if (!readDeviceList(argv[++i], opt.devices))
+                return false;
+        }
+        else if (!strcmp(arg, "--beacon"))
+            opt.beacon = true;
+        else if (!strcmp(arg, "--interval") && hasValue)
+            opt.interval = strtoul(argv[++i], nullptr, 10);
+        else if (!strcmp(arg, "--max-conn") && hasValue)
+            opt.maxConn = strtoul(argv[++i], nullptr, 10);
+        else if (!strcmp(arg, "--capacity") && hasValue)
+            opt.capacity = strtoul(argv[++i], nullptr, 10);
+        else if (!strcmp(arg, "--max-devices") && hasValue)
+            opt.maxDevices = strtoul(argv[++i], nullptr, 10);
+        else if (!strcmp(arg, "--dump"))
+        {
+            opt.dump = true;
+            if (hasValue && argv[i + 1][0] != '-')
+                opt.dumpDevice = argv[++i];
+        }
+        else if (!strcmp(arg, "--bench") && hasValue)
+            opt.bench = strtoul(argv[++i], nullptr, 10);
+        else if (!strcmp(arg, "--seconds") && hasValue)
+            opt.seconds = strtoul(argv[++i], nullptr, 10);
+        else
+            return false;
+    }
+    return opt.capacity > 0 && opt.maxDevices > 0 && opt.maxConn > 0;
+}
+
+// Cada dispositivo simulado usa 1 listener + 1 conexão de cada lado
+static void raiseFileLimit(size_t needed)
+{
+    rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < needed)
+    {
+        limit.rlim_cur = std::min<rlim_t>(needed, limit.rlim_max);
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+}
+
+static void printSample(const char *device, const Sample &s)
+{
+    char stamp[32];
+    time_t t = s.time;
+    strftime(stamp, sizeof(stamp), "%Y-%m-%d %H:%M:%S", localtime(&t));
+
+    printf("%s,%s,", device, stamp);
+    if (s.temperature != SAMPLE_NO_TEMPERATURE)
+        printf("%.1f", s.temperature / 10.0);
+    printf(",");
+    if (s.humidity != SAMPLE_NO_HUMIDITY)
+        printf("%.1f", s.humidity / 10.0);
+    printf(",%u,%u,%02u:%02u,%02u:%02u,%u\n", s.luminosity, s.pwm,
+           s.onMinutes / 60, s.onMinutes % 60, s.offMinutes / 60, s.offMinutes % 60, s.maxLight);
+}
+
+static int dump(const Options &opt)
+{
+    SeriesStore store;
+    if (!store.open(opt.store, opt.maxDevices, opt.capacity))
+        return 1;
+
+    static const uint32_t DAY = 24 * 3600;
+    uint32_t now = (uint32_t)time(nullptr);
+
+    if (opt.dumpDevice == nullptr)
+    {
+        printf("%-40s %12s\n", "dispositivo", "linhas");
+        for (uint32_t i = 0; i < store.deviceCount(); i++)
+        {
+            std::string name(store.deviceName(i));
+            printf("%-40s %12llu\n", name.c_str(), (unsigned long long)store.rowCount(i));
+        }
+        return 0;
+    }
+
+    for (uint32_t i = 0; i < store.deviceCount(); i++)
+    {
+        if (store.deviceName(i) != opt.dumpDevice)
+            continue;
+
+        std::vector<Sample> rows(opt.capacity);
+        size_t count = store.query(i, now - DAY, now, rows.data(), rows.size());
+        printf("dispositivo,hora,temperatura,humidade,luminosidade,pwm,hora_ligar,hora_desligar,luz_maxima\n");
+        for (size_t r = 0; r < count; r++)
+            printSample(opt.dumpDevice, rows[r]);
+        return 0;
+    }
+
+    fprintf(stderr, "Dispositivo nao encontrado: %s\n", opt.dumpDevice);
+    return 1;
+}
+
+static int collect(const Options &opt)
+{
+    if (opt.devices.empty() && !opt.beacon)
+    {
+        usage();
+        return 2;
+    }
+
+    raiseFileLimit(opt.maxConn + 64);
+
+    SeriesStore store;
+    if (!store.open(opt.store, opt.maxDevices, opt.capacity))
+        return 1;
+
+    Collector collector(store);
+    collector.setPollInterval(opt.interval);
+    collector.setMaxInFlight(opt.maxConn);
+    for (const std::string &device : opt.devices)
+        collector.addDevice(device.c_str());
+    if (opt.beacon && !collector.subscribeBeacon(BEACON_GROUP, BEACON_PORT))
+        return 1;
+
+    printf("[Collector] %zu dispositivos por HTTP%s, gravando em %s\n",
+           collector.deviceCount(), opt.beacon ? " + beacons" : "", opt.store);
+
+    while (!stopRequested)
+    {
+        collector.run(stopRequested, STATS_INTERVAL);
+        store.sync();
+
+        const CollectorStats &s = collector.stats();
+        printf("[Collector] respostas=%llu falhas=%llu beacons=%llu\n",
+               (unsigned long long)s.polls, (unsigned long long)s.failures, (unsigned long long)s.beacons);
+        fflush(stdout);
+    }
+    return 0;
+}
+
+static int bench(const Options &opt)
+{
+    raiseFileLimit(opt.bench + 2 * opt.maxConn + 64);
+
+    DeviceSimulator simulator;
+    if (!simulator.start(opt.bench))
+        return 1;
+
+    char path[] = "/tmp/fleet_bench_XXXXXX";
+    int fd = mkstemp(path);
+    if (fd < 0)
+    {
+        perror("mkstemp");
+        return 1;
+    }
+    close(fd);
+    unlink(path); // SeriesStore só cria o layout num arquivo vazio/inexistente
+
+    SeriesStore store;
+    if (!store.open(path, (uint32_t)opt.bench, opt.capacity))
+        return 1;
+
+    Collector collector(store);
+    collector.setPollInterval(0); // Cada dispositivo é consultado de novo assim que responde
+    collector.setMaxInFlight(opt.maxConn);
+    collector.setRecordLatency(true);
+
+    char endpoint[32];
+    for (uint16_t port : simulator.ports())
+    {
+        snprintf(endpoint, sizeof(endpoint), "127.0.0.1:%u", port);
+        collector.addDevice(endpoint);
+    }
+
+    printf("[Bench] %zu dispositivos simulados, %zu conexoes simultaneas, %lu s\n",
+           opt.bench, opt.maxConn, opt.seconds);
+
+    timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    collector.run(stopRequested, opt.seconds * 1000);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    simulator.stop();
+
+    double elapsed = (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) / 1e9;
+    CollectorStats s = collector.stats();
+    std::vector<uint32_t> &lat = s.latencyUs;
+    std::sort(lat.begin(), lat.end());
+
+    auto percentile = [&](double p) -> double
+    {
+        if (lat.empty())
+            return 0;
+        size_t i = (size_t)(p * (lat.size() - 1) + 0.5);
+        return lat[i] / 1000.0;
+    };
+
+    // Confere que cada dispositivo tem as linhas no arquivo
+    uint64_t rows = 0;
+    for (uint32_t i = 0; i < store.deviceCount(); i++)
+        rows += store.rowCount(i);
+
+    printf("[Bench] respostas: %llu  falhas: %llu  linhas gravadas: %llu\n",
+           (unsigned long long)s.polls, (unsigned long long)s.failures, (unsigned long long)rows);
+    printf("[Bench] dispositivos/s: %.0f\n", s.polls / elapsed);
+    printf("[Bench] latencia de ingestao (ms): p50 %.3f  p99 %.3f  max %.3f\n",
+           percentile(0.50), percentile(0.99), percentile(1.0));
+
+    store.close();
+    unlink(path);
+    return s.polls > 0 && rows == s.polls ? 0 : 1;
+}
+
+int main(int argc, char **argv)
+{
+    Options opt;
+    if (!parseArgs(argc, argv, opt))
+    {
+        usage();
+        return 2;
+    }
+
+    signal(SIGINT, onSignal);
+    signal(SIGTERM, onSignal);
+    signal(SIGPIPE, SIG_IGN);
+
+    if (opt.bench > 0)
+        return bench(opt);
+    if (opt.dump)
+        return dump(opt);
+    return collect(opt);
+}
@@ -0,0 +1,144 @@
+// Gera as imagens para o POST /update: a imagem inteira em zlib ou um
+// patch (delta) contra o firmware que está rodando, também em zlib.
+//
+// Compilação (Linux, na raiz do repositório):
+//   g++ -O2 -std=c++17 -I lib/OtaStream tools/ota_delta/ota_delta.cpp lib/OtaStream/*.cpp -lz -o ota_delta
+//
+// Uso:
+//   ota_delta zlib  NOVA.bin SAIDA.zz                  Imagem inteira comprimida
+//   ota_delta diff  ORIGEM.bin NOVA.bin SAIDA.delta   Patch de ORIGEM para NOVA, comprimido
+//   ota_delta apply ORIGEM.bin PATCH SAIDA.bin         Aplica como o ESP32 faria (conferência)
+//
+// ORIGEM.bin tem que ser exatamente o .bin que está gravado na placa.
+// O MD5 pedido no /update é o da imagem final: md5sum NOVA.bin
+
+#include <zlib.h>
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "DeltaEncoder.h"
+#include "DeltaPatch.h"
+#include "StreamInflate.h"
+
+typedef std::vector<uint8_t> Bytes;
+
+static bool readFile(const char *path, Bytes &out)
+{
+    FILE *f = fopen(path, "rb");
+    if (f == nullptr)
+    {
+        perror(path);
+        return false;
+    }
+    uint8_t buffer[65536];
+    size_t n;
+    while ((n = fread(buffer, 1, sizeof(buffer), f)) > 0)
+        out.insert(out.end(), buffer, buffer + n);
+    fclose(f);
+    return true;
+}
+
+static bool writeFile(const char *path, const Bytes &data)
+{
+    FILE *f = fopen(path, "wb");
+    if (f == nullptr || fwrite(data.data(), 1, data.size(), f) != data.size())
+    {
+        perror(path);
+        if (f != nullptr)
+            fclose(f);
+        return false;
+    }
+    return fclose(f) == 0;
+}
+
+static Bytes compress(const Bytes &data)
+{
+    uLongf size = compressBound(data.size());
+    Bytes out(size);
+    compress2(out.data(), &size, data.data(), data.size(), Z_BEST_COMPRESSION);
+    out.resize(size);
+    return out;
+}
+
+static bool collect(void *ctx, const uint8_t *data, size_t len)
+{
+    Bytes *out = (Bytes *)ctx;
+    out->insert(out->end(), data, data + len);
+    return true;
+}
+
+static bool readSource(void *ctx, uint32_t offset, uint8_t *data, size_t len)
+{
+    const Bytes *source = (const Bytes *)ctx;
+    if (offset + len > source->size())
+        return false;
+    memcpy(data, source->data() + offset, len);
+    return true;
+}
+
+static bool toPatch(void *ctx, const uint8_t *data, size_t len)
+{
+    return ((DeltaPatch *)ctx)->write(data, len);
+}
+
+static int apply(const Bytes &source, const Bytes &patch, const char *outPath)
+{
+    Bytes out;
+    DeltaPatch applier;
+    applier.begin(readSource, (void *)&source, collect, &out);
+    StreamInflate inflater;
+    if (!inflater.begin(toPatch, &applier))
+        return 1;
+
+    bool ok = inflater.write(patch.data(), patch.size()) && inflater.finished() && applier.finished();
+    if (!ok)
+    {
+        const char *error = applier.lastError() != nullptr ? applier.lastError() : inflater.lastError();
+        fprintf(stderr, "Erro: %s\n", error != nullptr ? error : "patch incompleto");
+        return 1;
+    }
+    printf("%zu bytes gerados\n", out.size());
+    return writeFile(outPath, out) ? 0 : 1;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc == 4 && !strcmp(argv[1], "zlib"))
+    {
+        Bytes image;
+        if (!readFile(argv[2], image))
+            return 1;
+        Bytes out = compress(image);
+        printf("imagem %zu B -> zlib %zu B (%.1f%%)\n", image.size(), out.size(), 100.0 * out.size() / image.size());
+        return writeFile(argv[3], out) ? 0 : 1;
+    }
+
+    if (argc == 5 && !strcmp(argv[1], "diff"))
+    {
+        Bytes source, target;
+        if (!readFile(argv[2], source) || !readFile(argv[3], target))
+            return 1;
+        Bytes patch = deltaEncode(source.data(), source.size(), target.data(), target.size());
+        Bytes out = compress(patch);
+        Bytes full = compress(target);
+        printf("imagem %zu B, zlib %zu B, patch %zu B, patch+zlib %zu B (%.1f%% do zlib)\n",
+               target.size(), full.size(), patch.size(), out.size(), 100.0 * out.size() / full.size());
+        return writeFile(argv[4], out) ? 0 : 1;
+    }
+
+    if (argc == 5 && !strcmp(argv[1], "apply"))
+    {
+        Bytes source, patch;
+        if (!readFile(argv[2], source) || !readFile(argv[3], patch))
+            return 1;
+        return apply(source, patch, argv[4]);
+    }
+
+    fprintf(stderr,
+            "Uso: ota_delta zlib  NOVA.bin SAIDA.zz\n"
+            "     ota_delta diff  ORIGEM.bin NOVA.bin SAIDA.delta\n"
+            "     ota_delta apply ORIGEM.bin PATCH SAIDA.bin\n");
+    return 2;
+}
@@ -0,0 +1,442 @@
+// Mede no PC o custo do TLS do dashboard (SecureDashboard/TlsTransport):
+// uma conexão por requisição GET /data.json, em quatro modos:
+//
+//   texto puro       TCP sem TLS (o dashboard da porta 80)
+//   TLS completo     handshake completo em toda conexão (esp_https_server do IDF 4.4)
+//   TLS retomado ID  retomada pelo cache de sessões do servidor
+//   TLS ticket       retomada por ticket (RFC 5077)
+//
+// O servidor usa a mesma configuração do TlsTransport (cache e tickets).
+// Servidor e cliente rodam no mesmo processo, pela interface de loopback.
+// Por conexão: tempo total no cliente, tempo de CPU do servidor no
+// handshake (o que pesa no ESP32) e bytes trocados.
+//
+// Compilação (Linux com mbedTLS 2.28, na raiz do repositório):
+//   g++ -O2 -std=c++17 tools/tls_bench/tls_bench.cpp -lmbedtls -lmbedx509 -lmbedcrypto -lpthread -o tls_bench
+//
+// Uso:
+//   ./tls_bench servidor.crt servidor.key [conexões]     (padrão 200)
+//
+// Os mesmos PEM gravados no NVS (SecureDashboard.h). Para gerar um par de teste:
+//   openssl req -x509 -newkey ec -pkeyopt ec_paramgen_curve:prime256v1 -nodes -subj /CN=esp32
+//       -keyout servidor.key -out servidor.crt
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <mbedtls/ctr_drbg.h>
+#include <mbedtls/entropy.h>
+#include <mbedtls/net_sockets.h>
+#include <mbedtls/pk.h>
+#include <mbedtls/ssl.h>
+#include <mbedtls/ssl_cache.h>
+#include <mbedtls/ssl_ticket.h>
+#include <mbedtls/x509_crt.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <thread>
+#include <vector>
+
+static const char REQUEST[] = "GET /data.json HTTP/1.1\r\nHost: esp32\r\nConnection: close\r\n\r\n";
+
+// Mesmo tamanho e forma do /data.json do dashboard
+static const char BODY[] = "{\"date\":\"19/10/2026\",\"time\":\"14:05:33\",\"temperatura\":23.4,\"humidade\":55.2,"
+                           "\"luminosidade\":2048,\"hora_ligar\":\"07:00\",\"hora_desligar\":\"22:00\","
+                           "\"luz_maxima\":80,\"pwm\":204,\"rssi\":-61}";
+
+enum Mode
+{
+    MODE_PLAIN,
+    MODE_FULL,
+    MODE_RESUME_ID,
+    MODE_RESUME_TICKET,
+};
+
+static const char *MODE_NAMES[] = {"texto puro", "TLS completo", "TLS retomado ID", "TLS ticket"};
+
+struct Result
+{
+    std::vector<double> clientUs;    // Conexão + handshake + pedido + resposta
+    std::vector<double> handshakeUs; // CPU do servidor no handshake
+    unsigned long bytes = 0;         // Enviados + recebidos pelo cliente
+    unsigned long resumed = 0;       // Handshakes que o servidor retomou
+};
+
+// --- Servidor (mesma configuração do TlsTransport) ---
+
+struct Server
+{
+    mbedtls_entropy_context entropy;
+    mbedtls_ctr_drbg_context drbg;
+    mbedtls_x509_crt cert;
+    mbedtls_pk_context key;
+    mbedtls_ssl_config config;
+    mbedtls_ssl_cache_context cache;
+    mbedtls_ssl_ticket_context ticket;
+    bool resuming;
+};
+
+static int cacheGet(void *ctx, mbedtls_ssl_session *session)
+{
+    Server *server = (Server *)ctx;
+    int ret = mbedtls_ssl_cache_get(&server->cache, session);
+    server->resuming |= ret == 0;
+    return ret;
+}
+
+static int cacheSet(void *ctx, const mbedtls_ssl_session *session)
+{
+    return mbedtls_ssl_cache_set(&((Server *)ctx)->cache, session);
+}
+
+static int ticketWrite(void *ctx, const mbedtls_ssl_session *session, unsigned char *start, const unsigned char *end,
+                       size_t *length, uint32_t *lifetime)
+{
+    return mbedtls_ssl_ticket_write(&((Server *)ctx)->ticket, session, start, end, length, lifetime);
+}
+
+static int ticketParse(void *ctx, mbedtls_ssl_session *session, unsigned char *buf, size_t len)
+{
+    Server *server = (Server *)ctx;
+    int ret = mbedtls_ssl_ticket_parse(&server->ticket, session, buf, len);
+    server->resuming |= ret == 0;
+    return ret;
+}
+
+static bool setupServer(Server &server, const char *certPath, const char *keyPath)
+{
+    mbedtls_entropy_init(&server.entropy);
+    mbedtls_ctr_drbg_init(&server.drbg);
+    mbedtls_x509_crt_init(&server.cert);
+    mbedtls_pk_init(&server.key);
+    mbedtls_ssl_config_init(&server.config);
+    mbedtls_ssl_cache_init(&server.cache);
+    mbedtls_ssl_ticket_init(&server.ticket);
+
+    int ret = mbedtls_ctr_drbg_seed(&server.drbg, mbedtls_entropy_func, &server.entropy, nullptr, 0);
+    if (ret == 0)
+        ret = mbedtls_x509_crt_parse_file(&server.cert, certPath);
+    if (ret == 0)
+        ret = mbedtls_pk_parse_keyfile(&server.key, keyPath, nullptr);
+    if (ret == 0)
+        ret = mbedtls_ssl_config_defaults(&server.config, MBEDTLS_SSL_IS_SERVER, MBEDTLS_SSL_TRANSPORT_STREAM,
+                                          MBEDTLS_SSL_PRESET_DEFAULT);
+    if (ret == 0)
+        ret = mbedtls_ssl_conf_own_cert(&server.config, &server.cert, &server.key);
+    if (ret == 0)
+        ret = mbedtls_ssl_ticket_setup(&server.ticket, mbedtls_ctr_drbg_random, &server.drbg,
+                                       MBEDTLS_CIPHER_AES_256_GCM, 86400);
+    if (ret != 0)
+    {
+        fprintf(stderr, "Certificado, chave ou configuracao invalidos (mbedTLS -0x%04x)\n", (unsigned)-ret);
+        return false;
+    }
+    mbedtls_ssl_conf_rng(&server.config, mbedtls_ctr_drbg_random, &server.drbg);
+    mbedtls_ssl_cache_set_max_entries(&server.cache, 8); // TLS_SESSION_CACHE_SIZE
+    mbedtls_ssl_cache_set_timeout(&server.cache, 86400);
+    mbedtls_ssl_conf_session_cache(&server.config, &server, cacheGet, cacheSet);
+    mbedtls_ssl_conf_session_tickets_cb(&server.config, ticketWrite, ticketParse, &server);
+    return true;
+}
+
+static double threadCpuUs()
+{
+    timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+// Lê até o fim dos cabeçalhos do pedido
+template <class Read>
+static bool readRequest(Read read)
+{
+    std::string request;
+    char buffer[256];
+    while (request.find("\r\n\r\n") == std::string::npos)
+    {
+        int n = read((unsigned char *)buffer, sizeof(buffer));
+        if (n <= 0)
+            return false;
+        request.append(buffer, n);
+    }
+    return true;
+}
+
+static std::string response()
+{
+    char header[128];
+    snprintf(header, sizeof(header),
+             "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nContent-Length: %zu\r\nConnection: close\r\n\r\n",
+             strlen(BODY));
+    return std::string(header) + BODY;
+}
+
+static void serve(Server &server, int listener, Mode mode, int connections, Result &result)
+{
+    std::string reply = response();
+    for (int i = 0; i < connections; i++)
+    {
+        int fd = accept(listener, nullptr, nullptr);
+        if (fd < 0)
+            return;
+        // Sem Nagle: os registros do handshake saem na hora (senão o ACK atrasado soma ~40 ms)
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+        if (mode == MODE_PLAIN)
+        {
+            if (readRequest([fd](unsigned char *buf, size_t len) { return (int)recv(fd, buf, len, 0); }))
+                send(fd, reply.data(), reply.size(), 0);
+            close(fd);
+            continue;
+        }
+
+        mbedtls_net_context net;
+        net.fd = fd;
+        mbedtls_ssl_context ssl;
+        mbedtls_ssl_init(&ssl);
+        mbedtls_ssl_setup(&ssl, &server.config);
+        mbedtls_ssl_set_bio(&ssl, &net, mbedtls_net_send, mbedtls_net_recv, nullptr);
+
+        server.resuming = false;
+        double start = threadCpuUs();
+        int ret = mbedtls_ssl_handshake(&ssl);
+        result.handshakeUs.push_back(threadCpuUs() - start);
+        if (ret == 0)
+        {
+            result.resumed += server.resuming;
+            if (readRequest([&ssl](unsigned char *buf, size_t len) { return mbedtls_ssl_read(&ssl, buf, len); }))
+                mbedtls_ssl_write(&ssl, (const unsigned char *)reply.data(), reply.size());
+            mbedtls_ssl_close_notify(&ssl);
+        }
+        else
+        {
+            fprintf(stderr, "Handshake do servidor falhou (mbedTLS -0x%04x)\n", (unsigned)-ret);
+        }
+        mbedtls_ssl_free(&ssl);
+        close(fd);
+    }
+}
+
+// --- Cliente ---
+
+struct CountingSocket
+{
+    mbedtls_net_context net;
+    unsigned long bytes;
+};
+
+static int countingSend(void *ctx, const unsigned char *buf, size_t len)
+{
+    CountingSocket *socket = (CountingSocket *)ctx;
+    int n = mbedtls_net_send(&socket->net, buf, len);
+    if (n > 0)
+        socket->bytes += n;
+    return n;
+}
+
+static int countingRecv(void *ctx, unsigned char *buf, size_t len)
+{
+    CountingSocket *socket = (CountingSocket *)ctx;
+    int n = mbedtls_net_recv(&socket->net, buf, len);
+    if (n > 0)
+        socket->bytes += n;
+    return n;
+}
+
+static int connectTo(uint16_t port)
+{
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (connect(fd, (sockaddr *)&address, sizeof(address)) != 0)
+    {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static bool runClient(uint16_t port, Mode mode, int connections, mbedtls_ctr_drbg_context &drbg, Result &result)
+{
+    mbedtls_ssl_config config;
+    mbedtls_ssl_config_init(&config);
+    mbedtls_ssl_config_defaults(&config, MBEDTLS_SSL_IS_CLIENT, MBEDTLS_SSL_TRANSPORT_STREAM,
+                                MBEDTLS_SSL_PRESET_DEFAULT);
+    mbedtls_ssl_conf_rng(&config, mbedtls_ctr_drbg_random, &drbg);
+    mbedtls_ssl_conf_authmode(&config, MBEDTLS_SSL_VERIFY_NONE); // Certificado autoassinado de teste
+    // Sem ticket, a retomada só pode vir do cache de sessões do servidor
+    mbedtls_ssl_conf_session_tickets(&config, mode == MODE_RESUME_TICKET ? MBEDTLS_SSL_SESSION_TICKETS_ENABLED
+                                                                         : MBEDTLS_SSL_SESSION_TICKETS_DISABLED);
+
+    mbedtls_ssl_session saved;
+    mbedtls_ssl_session_init(&saved);
+    bool haveSession = false;
+    bool ok = true;
+
+    for (int i = 0; i < connections && ok; i++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        int fd = connectTo(port);
+        if (fd < 0)
+            return false;
+
+        std::string received;
+        unsigned char buffer[1024];
+        if (mode == MODE_PLAIN)
+        {
+            send(fd, REQUEST, sizeof(REQUEST) - 1, 0);
+            result.bytes += sizeof(REQUEST) - 1;
+            int n;
+            while ((n = (int)recv(fd, buffer, sizeof(buffer), 0)) > 0)
+                received.append((char *)buffer, n);
+            result.bytes += received.size();
+        }
+        else
+        {
+            CountingSocket socket = {{fd}, 0};
+            mbedtls_ssl_context ssl;
+            mbedtls_ssl_init(&ssl);
+            mbedtls_ssl_setup(&ssl, &config);
+            mbedtls_ssl_set_bio(&ssl, &socket, countingSend, countingRecv, nullptr);
+            if (haveSession && mode != MODE_FULL)
+                mbedtls_ssl_set_session(&ssl, &saved);
+
+            int ret = mbedtls_ssl_handshake(&ssl);
+            if (ret != 0)
+            {
+                fprintf(stderr, "Handshake do cliente falhou (mbedTLS -0x%04x)\n", (unsigned)-ret);
+                ok = false;
+            }
+            else
+            {
+                if (mode != MODE_FULL)
+                    haveSession = mbedtls_ssl_get_session(&ssl, &saved) == 0;
+                mbedtls_ssl_write(&ssl, (const unsigned char *)REQUEST, sizeof(REQUEST) - 1);
+                int n;
+                while ((n = mbedtls_ssl_read(&ssl, buffer, sizeof(buffer))) > 0)
+                    received.append((char *)buffer, n);
+                mbedtls_ssl_close_notify(&ssl);
+            }
+            mbedtls_ssl_free(&ssl);
+            result.bytes += socket.bytes;
+        }
+        close(fd);
+        result.clientUs.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+
+        if (received.find(BODY) == std::string::npos)
+        {
+            fprintf(stderr, "%s: resposta incompleta na conexao %d\n", MODE_NAMES[mode], i);
+            ok = false;
+        }
+    }
+
+    mbedtls_ssl_session_free(&saved);
+    mbedtls_ssl_config_free(&config);
+    return ok;
+}
+
+// --- Medição ---
+
+static double median(std::vector<double> values)
+{
+    if (values.empty())
+        return 0;
+    std::sort(values.begin(), values.end());
+    return values[values.size() / 2];
+}
+
+static int listenOnLoopback(uint16_t &port)
+{
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t length = sizeof(address);
+    if (bind(fd, (sockaddr *)&address, sizeof(address)) != 0 || listen(fd, 16) != 0 ||
+        getsockname(fd, (sockaddr *)&address, &length) != 0)
+    {
+        close(fd);
+        return -1;
+    }
+    port = ntohs(address.sin_port);
+    return fd;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 3)
+    {
+        fprintf(stderr, "Uso: %s servidor.crt servidor.key [conexoes]\n", argv[0]);
+        return 2;
+    }
+    int connections = argc > 3 ? atoi(argv[3]) : 200;
+    if (connections < 2)
+        connections = 2;
+
+    Server server;
+    if (!setupServer(server, argv[1], argv[2]))
+        return 1;
+
+    mbedtls_entropy_context entropy;
+    mbedtls_ctr_drbg_context drbg;
+    mbedtls_entropy_init(&entropy);
+    mbedtls_ctr_drbg_init(&drbg);
+    mbedtls_ctr_drbg_seed(&drbg, mbedtls_entropy_func, &entropy, nullptr, 0);
+
+    uint16_t port;
+    int listener = listenOnLoopback(port);
+    if (listener < 0)
+    {
+        perror("listen");
+        return 1;
+    }
+
+    printf("%d conexoes por modo, uma requisicao cada (mediana por conexao)\n\n", connections);
+    printf("%-16s %12s %16s %10s %10s\n", "modo", "cliente us", "CPU handshake us", "bytes", "retomadas");
+
+    Result results[4];
+    int status = 0;
+    for (int m = MODE_PLAIN; m <= MODE_RESUME_TICKET; m++)
+    {
+        Mode mode = (Mode)m;
+        Result &result = results[m];
+        std::thread serverThread(serve, std::ref(server), listener, mode, connections, std::ref(result));
+        bool ok = runClient(port, mode, connections, drbg, result);
+        serverThread.join();
+
+        printf("%-16s %12.1f %16.1f %10lu %10lu\n", MODE_NAMES[m], median(result.clientUs),
+               median(result.handshakeUs), result.bytes / connections, result.resumed);
+
+        // A primeira conexão de um modo com retomada é sempre completa
+        unsigned long expected = mode == MODE_RESUME_ID || mode == MODE_RESUME_TICKET ? connections - 1 : 0;
+        if (!ok || result.resumed != expected)
+        {
+            fprintf(stderr, "%s: falhou ou retomou %lu de %lu conexoes\n", MODE_NAMES[m], result.resumed, expected);
+            status = 1;
+        }
+    }
+
+    double full = median(results[MODE_FULL].handshakeUs);
+    printf("\nCPU do servidor no handshake, em relacao ao completo: retomado ID %.1f%%, ticket %.1f%%\n",
+           100 * median(results[MODE_RESUME_ID].handshakeUs) / full,
+           100 * median(results[MODE_RESUME_TICKET].handshakeUs) / full);
+
+    close(listener);
+    return status;
+}